@@ -0,0 +1,183 @@
+// Self-play throughput benchmark: plays seeded batches of complete games
+// through the game core and prints the results as JSON
+//
+//   blockblast-bench [--games N] [--seed S] [--soak SECONDS] [--out FILE]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "selfplay.h"
+#include "oracle.h"
+#include "piece_catalog.h"
+
+#ifndef BENCH_GIT_REV
+#define BENCH_GIT_REV "unknown"
+#endif
+
+// Largest RSS growth over a soak run still considered flat
+#define SOAK_RSS_SLACK_KB 64
+
+typedef struct {
+    long games;
+    uint64_t seed;
+    int soak_seconds;
+    const char *out_path;
+} bench_options_t;
+
+typedef struct {
+    long games;
+    long placements;
+    long spawns;
+    long lines;
+    long score;
+    uint64_t checksum; // order-independent digest of every game's outcome
+    uint64_t elapsed_ns;
+    selfplay_timing_t timing;
+} bench_totals_t;
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s [--games N] [--seed S] [--soak SECONDS] [--out FILE]\n", argv0);
+}
+
+static int parse_options(int argc, char **argv, bench_options_t *opt)
+{
+    opt->games = 1000;
+    opt->seed = 1;
+    opt->soak_seconds = 0;
+    opt->out_path = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!strcmp(arg, "--games") && value) opt->games = atol(argv[++i]);
+        else if (!strcmp(arg, "--seed") && value) opt->seed = strtoull(argv[++i], NULL, 0);
+        else if (!strcmp(arg, "--soak") && value) opt->soak_seconds = atoi(argv[++i]);
+        else if (!strcmp(arg, "--out") && value) opt->out_path = argv[++i];
+        else return 0;
+    }
+    return opt->games > 0 && opt->soak_seconds >= 0;
+}
+
+// resident set size in KiB, or 0 if unavailable
+static long rss_kb(void)
+{
+    FILE *fp = fopen("/proc/self/statm", "r");
+    if (!fp) return 0;
+    long size = 0, resident = 0;
+    if (fscanf(fp, "%ld %ld", &size, &resident) != 2) resident = 0;
+    fclose(fp);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static void play_one(bench_totals_t *totals, const bench_options_t *opt, long index)
+{
+    selfplay_result_t result;
+    selfplay_play_game(opt->seed, (uint64_t)index, &result, &totals->timing);
+    totals->games++;
+    totals->placements += result.placements;
+    totals->spawns += result.spawns;
+    totals->lines += result.lines;
+    totals->score += result.score;
+    totals->checksum += (uint64_t)result.score * 0x9E3779B97F4A7C15ull ^ (uint64_t)result.placements;
+}
+
+static void print_hist(FILE *out, const char *name, const latency_hist_t *hist, int last)
+{
+    fprintf(out, "    \"%s\": {\"count\": %llu, \"mean_ns\": %.1f, \"p50_ns\": %llu, "
+                 "\"p99_ns\": %llu, \"max_ns\": %llu}%s\n",
+            name, (unsigned long long)hist->count, latency_hist_mean(hist),
+            (unsigned long long)latency_hist_quantile(hist, 0.50),
+            (unsigned long long)latency_hist_quantile(hist, 0.99),
+            (unsigned long long)hist->max, last ? "" : ",");
+}
+
+int main(int argc, char **argv)
+{
+    bench_options_t opt;
+    if (!parse_options(argc, argv, &opt))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    bench_totals_t totals;
+    memset(&totals, 0, sizeof(totals));
+    selfplay_timing_init(&totals.timing);
+
+    // Batch: a fixed number of games
+    uint64_t start = latency_now_ns();
+    long index = 0;
+    for (; index < opt.games; index++) play_one(&totals, &opt, index);
+    totals.elapsed_ns = latency_now_ns() - start;
+
+    // Soak: keep playing and sample the RSS once per second
+    long rss_start = 0, rss_end = 0, rss_max = 0, soak_games = 0;
+    if (opt.soak_seconds > 0)
+    {
+        rss_start = rss_max = rss_kb();
+        uint64_t soak_start = latency_now_ns();
+        uint64_t next_sample = soak_start + 1000000000ull;
+        uint64_t soak_end = soak_start + (uint64_t)opt.soak_seconds * 1000000000ull;
+        bench_totals_t soak;
+        memset(&soak, 0, sizeof(soak));
+        selfplay_timing_init(&soak.timing);
+        for (uint64_t now = soak_start; now < soak_end; now = latency_now_ns())
+        {
+            play_one(&soak, &opt, index++);
+            if (now >= next_sample)
+            {
+                long rss = rss_kb();
+                if (rss > rss_max) rss_max = rss;
+                next_sample += 1000000000ull;
+            }
+        }
+        rss_end = rss_kb();
+        if (rss_end > rss_max) rss_max = rss_end;
+        soak_games = soak.games;
+    }
+    int soak_flat = rss_max - rss_start <= SOAK_RSS_SLACK_KB;
+
+    FILE *out = stdout;
+    if (opt.out_path && !(out = fopen(opt.out_path, "w")))
+    {
+        perror(opt.out_path);
+        return 1;
+    }
+
+    double seconds = (double)totals.elapsed_ns / 1e9;
+    fprintf(out, "{\n");
+    fprintf(out, "  \"benchmark\": \"selfplay\",\n");
+    fprintf(out, "  \"git_rev\": \"%s\",\n", BENCH_GIT_REV);
+    fprintf(out, "  \"seed\": %llu,\n", (unsigned long long)opt.seed);
+    fprintf(out, "  \"games\": %ld,\n", totals.games);
+    fprintf(out, "  \"placements\": %ld,\n", totals.placements);
+    fprintf(out, "  \"spawns\": %ld,\n", totals.spawns);
+    fprintf(out, "  \"lines\": %ld,\n", totals.lines);
+    fprintf(out, "  \"mean_score\": %.2f,\n", (double)totals.score / (double)totals.games);
+    fprintf(out, "  \"checksum\": \"%016llx\",\n", (unsigned long long)totals.checksum);
+    fprintf(out, "  \"elapsed_s\": %.6f,\n", seconds);
+    fprintf(out, "  \"games_per_s\": %.1f,\n", (double)totals.games / seconds);
+    fprintf(out, "  \"placements_per_s\": %.1f,\n", (double)totals.placements / seconds);
+    fprintf(out, "  \"piece_shapes\": %d,\n", piece_catalog_num_shapes());
+    // Bound on the word operations behind one game_over sample
+    fprintf(out, "  \"game_over_worst_case_ops\": %d,\n", oracle_worst_case_ops());
+    fprintf(out, "  \"latency\": {\n");
+    print_hist(out, "place", &totals.timing.place, 0);
+    print_hist(out, "spawn", &totals.timing.spawn, 0);
+    print_hist(out, "game_over", &totals.timing.game_over, 1);
+    fprintf(out, "  }");
+    if (opt.soak_seconds > 0)
+    {
+        fprintf(out, ",\n  \"soak\": {\"seconds\": %d, \"games\": %ld, \"rss_start_kb\": %ld, "
+                     "\"rss_end_kb\": %ld, \"rss_max_kb\": %ld, \"flat\": %s}",
+                opt.soak_seconds, soak_games, rss_start, rss_end, rss_max,
+                soak_flat ? "true" : "false");
+    }
+    fprintf(out, "\n}\n");
+    if (out != stdout) fclose(out);
+
+    return soak_flat ? 0 : 1;
+}
@@ -0,0 +1,367 @@
+// Drawing benchmark: times the pre-span per-pixel draw paths (dpixel per
+// pixel, /255 blends) against the span, sprite and text cache paths on a host VRAM,
+// and checks that both produce the same pixels. It also checks the packed
+// two-pixel blend kernels against a per-channel blend and blend565
+//
+//   blockblast-drawbench [--frames N] [--out FILE]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <gint/display.h>
+#include "latency_hist.h"
+#include "font.h"
+#include "span.h"
+#include "tile_cache.h"
+#include "particles.h"
+#include "blend.h"
+
+#ifndef BENCH_GIT_REV
+#define BENCH_GIT_REV "unknown"
+#endif
+
+#define COLOR_BLACK 0x0000
+#define COLOR_WHITE 0xFFFF
+#define COLOR_TETRIS_RED 0xF800
+
+// Grid geometry of the add-in (grid.h, tetris_blocks.h)
+#define GRID_X_OFFSET 118
+#define GRID_Y_OFFSET 32
+#define GRID_CELL_SIZE 20
+#define TETRIS_BLOCK_SIZE 15
+#define NUM_PARTICLES PARTICLES_MAX
+
+static const uint16_t palette[7] = { 0xF800, 0xFD20, 0xFEA0, 0x07E0, 0x2F1F, 0x22DF, 0xBA3F };
+
+// Text drawn by a typical frame: score panel and footer
+static const char *const frame_text[] = {
+    "SCORE: 1234", "HSCORE: 980", "UNSAVED", "F1=RESET", "F6=SAVE SCORE", "EXIT=UNSELECT",
+};
+
+// --- Reference: the per-pixel paths before the span layer ---
+
+static uint16_t ref_blend565(uint16_t a, uint16_t b, int t)
+{
+    int ar = (a >> 11) & 0x1F, ag = (a >> 5) & 0x3F, ab = a & 0x1F;
+    int br = (b >> 11) & 0x1F, bg = (b >> 5) & 0x3F, bb = b & 0x1F;
+    int rr = (ar * (255 - t) + br * t) / 255;
+    int rg = (ag * (255 - t) + bg * t) / 255;
+    int rb = (ab * (255 - t) + bb * t) / 255;
+    return (uint16_t)((rr << 11) | (rg << 5) | rb);
+}
+
+static void ref_bevel_tile(int x, int y, int size, int is_selected, uint16_t base)
+{
+    const uint16_t deep = ref_blend565(base, COLOR_BLACK, 180);
+    for (int py = 0; py < size; py++)
+    {
+        for (int px = 0; px < size; px++)
+        {
+            int dx = (px - size / 2);
+            int dy = (py - size / 2);
+            int d2 = dx*dx + dy*dy;
+            int maxd2 = (size*size)/2;
+            if (maxd2 <= 0) maxd2 = 1;
+            int t = d2 * 255 / maxd2; if (t > 255) t = 255;
+            dpixel(x + px, y + py, ref_blend565(base, deep, t/2));
+        }
+    }
+    int rim = size / 6; if (rim < 2) rim = 2; if (rim > 4) rim = 4;
+    for (int i = 0; i < rim; i++)
+    {
+        uint16_t edgeLight = ref_blend565(base, COLOR_WHITE, 160 - i*40);
+        uint16_t edgeDark = ref_blend565(base, deep, 200);
+        for (int px = i; px < size - i; px++) dpixel(x + px, y + i, edgeLight);
+        for (int py = i; py < size - i; py++) dpixel(x + i, y + py, edgeLight);
+        for (int px = i; px < size - i; px++) dpixel(x + px, y + size - 1 - i, edgeDark);
+        for (int py = i; py < size - i; py++) dpixel(x + size - 1 - i, y + py, edgeDark);
+    }
+    for (int px = 0; px < size; px++) { dpixel(x + px, y, COLOR_BLACK); dpixel(x + px, y + size - 1, COLOR_BLACK); }
+    for (int py = 0; py < size; py++) { dpixel(x, y + py, COLOR_BLACK); dpixel(x + size - 1, y + py, COLOR_BLACK); }
+    if (is_selected)
+    {
+        for (int px = 0; px < size; px++) { dpixel(x + px, y, COLOR_WHITE); dpixel(x + px, y + size - 1, COLOR_WHITE); }
+        for (int py = 0; py < size; py++) { dpixel(x, y + py, COLOR_WHITE); dpixel(x + size - 1, y + py, COLOR_WHITE); }
+    }
+}
+
+static void ref_draw_text(int x, int y, const char *text)
+{
+    for (; *text; text++, x += 8)
+    {
+        const uint8_t *glyph = font_get_glyph(*text);
+        if (!glyph || *text == ' ') continue;
+        for (int row = 0; row < 8; row++)
+        {
+            for (int col = 0; col < 8; col++)
+            {
+                if (glyph[row] & (0x80 >> col)) dpixel(x + col, y + row, COLOR_WHITE);
+            }
+        }
+    }
+}
+
+// --- Workload: the tiles, text and particles of one busy frame ---
+
+typedef struct {
+    int x, y;
+} point_t;
+
+static point_t particles[NUM_PARTICLES];
+
+static void tiles_before(void)
+{
+    for (int i = 0; i < 64; i++)
+    {
+        ref_bevel_tile(GRID_X_OFFSET + (i % 8) * GRID_CELL_SIZE, GRID_Y_OFFSET + (i / 8) * GRID_CELL_SIZE,
+                       GRID_CELL_SIZE, 0, palette[i % 7]);
+    }
+    for (int i = 0; i < 12; i++)
+    {
+        ref_bevel_tile(25 + (i % 4) * 16, 15 + (i / 4) * 70, TETRIS_BLOCK_SIZE, i < 4, palette[i % 7]);
+    }
+}
+
+static void tiles_after(void)
+{
+    for (int i = 0; i < 64; i++)
+    {
+        tile_cache_draw(GRID_X_OFFSET + (i % 8) * GRID_CELL_SIZE, GRID_Y_OFFSET + (i / 8) * GRID_CELL_SIZE,
+                        GRID_CELL_SIZE, 0, palette[i % 7]);
+    }
+    for (int i = 0; i < 12; i++)
+    {
+        tile_cache_draw(25 + (i % 4) * 16, 15 + (i / 4) * 70, TETRIS_BLOCK_SIZE, i < 4, palette[i % 7]);
+    }
+}
+
+static void text_before(void)
+{
+    for (int i = 0; i < 6; i++) ref_draw_text(288, 42 + 12 * i, frame_text[i]);
+}
+
+static void text_after(void)
+{
+    for (int i = 0; i < 6; i++) font_draw_text(288, 42 + 12 * i, frame_text[i]);
+}
+
+// Labels redrawn unchanged (opaque on a black background, like the VRAM
+// the comparison starts from)
+static void text_cached_after(void)
+{
+    for (int i = 0; i < 6; i++) font_draw_text_cached(288, 42 + 12 * i, frame_text[i], COLOR_BLACK);
+}
+
+static void particles_before(void)
+{
+    for (int i = 0; i < NUM_PARTICLES; i++)
+    {
+        for (int py = 0; py < 2; py++)
+        {
+            for (int px = 0; px < 2; px++) dpixel(particles[i].x + px, particles[i].y + py, COLOR_TETRIS_RED);
+        }
+    }
+}
+
+static void particles_after(void)
+{
+    particles_draw(COLOR_TETRIS_RED);
+}
+
+typedef struct {
+    const char *name;
+    void (*before)(void);
+    void (*after)(void);
+} draw_case_t;
+
+static const draw_case_t cases[] = {
+    { "tiles", tiles_before, tiles_after },
+    { "text", text_before, text_after },
+    { "text_cached", text_before, text_cached_after },
+    { "particles", particles_before, particles_after },
+};
+#define NUM_CASES ((int)(sizeof(cases) / sizeof(cases[0])))
+
+static uint16_t snapshot[DWIDTH * DHEIGHT];
+
+// 1 if both paths leave the same pixels on a cleared VRAM
+static int same_pixels(const draw_case_t *c)
+{
+    memset(gint_vram, 0, sizeof(snapshot));
+    c->before();
+    memcpy(snapshot, gint_vram, sizeof(snapshot));
+    memset(gint_vram, 0, sizeof(snapshot));
+    c->after();
+    return !memcmp(snapshot, gint_vram, sizeof(snapshot));
+}
+
+// --- Packed blend kernels against per-channel blends ---
+
+// Random pixel pairs tried at every weight
+#define BLEND_CHECK_PAIRS 200000
+#define BLEND_SPAN_LEN 37
+
+typedef struct {
+    long checked;
+    long wrong;      // results that differ from ref_blend565_w
+    int max_error;   // largest channel difference from blend565, in its own units
+} blend_check_t;
+
+// What blend565_w computes, one channel at a time
+static uint16_t ref_blend565_w(uint16_t a, uint16_t b, int w)
+{
+    int r = (((a >> 11) & 0x1F) * (32 - w) + ((b >> 11) & 0x1F) * w) >> 5;
+    int g = (((a >> 5) & 0x3F) * (32 - w) + ((b >> 5) & 0x3F) * w) >> 5;
+    int bl = ((a & 0x1F) * (32 - w) + (b & 0x1F) * w) >> 5;
+    return (uint16_t)((r << 11) | (g << 5) | bl);
+}
+
+static int channel_error(uint16_t x, uint16_t y)
+{
+    int dr = abs(((x >> 11) & 0x1F) - ((y >> 11) & 0x1F));
+    int dg = abs(((x >> 5) & 0x3F) - ((y >> 5) & 0x3F));
+    int db = abs((x & 0x1F) - (y & 0x1F));
+    int e = dr > dg ? dr : dg;
+    return e > db ? e : db;
+}
+
+static void check_pixel(blend_check_t *check, uint16_t got, uint16_t a, uint16_t b, int w, int t)
+{
+    check->checked++;
+    if (got != ref_blend565_w(a, b, w)) check->wrong++;
+    int e = channel_error(got, blend565(a, b, t));
+    if (e > check->max_error) check->max_error = e;
+}
+
+static void check_blend(blend_check_t *check)
+{
+    memset(check, 0, sizeof(*check));
+    uint32_t seed = 777;
+    for (long i = 0; i < BLEND_CHECK_PAIRS; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t a = seed;
+        seed = seed * 1103515245u + 12345u;
+        uint32_t b = seed ^ (a << 16);
+        for (int w = 0; w <= 32; w++)
+        {
+            uint32_t got = blend565_x2(a, b, w);
+            int t = w * 255 / 32;
+            check_pixel(check, (uint16_t)got, (uint16_t)a, (uint16_t)b, w, t);
+            check_pixel(check, (uint16_t)(got >> 16), (uint16_t)(a >> 16), (uint16_t)(b >> 16), w, t);
+        }
+    }
+
+    // Spans at both alignments of dst and src, with odd lengths, so the
+    // unaligned ends and the copied src words are covered
+    uint16_t src[BLEND_SPAN_LEN + 1], dst[BLEND_SPAN_LEN + 1], before[BLEND_SPAN_LEN + 1];
+    for (int t = 0; t < 256; t++)
+    {
+        int w = blend565_weight(t);
+        for (int offset = 0; offset < 4; offset++)
+        {
+            int d0 = offset & 1, s0 = offset >> 1;
+            for (int i = 0; i <= BLEND_SPAN_LEN; i++)
+            {
+                seed = seed * 1103515245u + 12345u;
+                src[i] = (uint16_t)(seed >> 16);
+                seed = seed * 1103515245u + 12345u;
+                dst[i] = before[i] = (uint16_t)(seed >> 16);
+            }
+            blend565_span(dst + d0, src + s0, BLEND_SPAN_LEN, t);
+            for (int i = 0; i < BLEND_SPAN_LEN; i++)
+            {
+                check_pixel(check, dst[d0 + i], before[d0 + i], src[s0 + i], w, t);
+            }
+
+            memcpy(dst, before, sizeof(dst));
+            blend565_span_color(dst + d0, BLEND_SPAN_LEN, src[0], t);
+            for (int i = 0; i < BLEND_SPAN_LEN; i++)
+            {
+                check_pixel(check, dst[d0 + i], before[d0 + i], src[0], w, t);
+            }
+        }
+    }
+}
+
+static uint64_t time_ns(void (*draw)(void), long frames)
+{
+    uint64_t start = latency_now_ns();
+    for (long i = 0; i < frames; i++) draw();
+    return latency_now_ns() - start;
+}
+
+int main(int argc, char **argv)
+{
+    long frames = 2000;
+    const char *out_path = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--frames") && i + 1 < argc) frames = atol(argv[++i]);
+        else if (!strcmp(argv[i], "--out") && i + 1 < argc) out_path = argv[++i];
+        else
+        {
+            fprintf(stderr, "usage: %s [--frames N] [--out FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (frames <= 0) frames = 1;
+
+    // Particles spread over the grid, some partly off screen
+    uint32_t seed = 12345;
+    for (int i = 0; i < NUM_PARTICLES; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        particles[i].x = (int)(seed >> 16) % (DWIDTH + 2) - 1;
+        seed = seed * 1103515245u + 12345u;
+        particles[i].y = (int)(seed >> 16) % (DHEIGHT + 2) - 1;
+        particles_spawn(particles[i].x * PARTICLE_ONE, particles[i].y * PARTICLE_ONE, 0, 0, 1);
+    }
+
+    FILE *out = stdout;
+    if (out_path && !(out = fopen(out_path, "w")))
+    {
+        perror(out_path);
+        return 1;
+    }
+
+    blend_check_t blend_check;
+    check_blend(&blend_check);
+
+    int all_same = 1;
+    uint64_t total_before = 0, total_after = 0;
+    fprintf(out, "{\n");
+    fprintf(out, "  \"benchmark\": \"draw\",\n");
+    fprintf(out, "  \"git_rev\": \"%s\",\n", BENCH_GIT_REV);
+    fprintf(out, "  \"frames\": %ld,\n", frames);
+    fprintf(out, "  \"cases\": {\n");
+    for (int i = 0; i < NUM_CASES; i++)
+    {
+        int same = same_pixels(&cases[i]);
+        uint64_t before = time_ns(cases[i].before, frames);
+        uint64_t after = time_ns(cases[i].after, frames);
+        all_same &= same;
+        total_before += before;
+        total_after += after;
+        fprintf(out, "    \"%s\": {\"before_ns_per_frame\": %.1f, \"after_ns_per_frame\": %.1f, "
+                     "\"speedup\": %.2f, \"identical\": %s}%s\n",
+                cases[i].name, (double)before / frames, (double)after / frames,
+                (double)before / (double)(after ? after : 1), same ? "true" : "false",
+                i + 1 < NUM_CASES ? "," : "");
+    }
+    fprintf(out, "  },\n");
+
+    tile_cache_stats_t stats;
+    tile_cache_get_stats(&stats);
+    fprintf(out, "  \"frame\": {\"before_ns\": %.1f, \"after_ns\": %.1f, \"speedup\": %.2f},\n",
+            (double)total_before / frames, (double)total_after / frames,
+            (double)total_before / (double)(total_after ? total_after : 1));
+    fprintf(out, "  \"tile_cache\": {\"atlas\": %u, \"hits\": %u, \"misses\": %u, \"entries\": %d},\n",
+            stats.atlas, stats.hits, stats.misses, stats.entries);
+    fprintf(out, "  \"blend_x2\": {\"checked\": %ld, \"wrong\": %ld, \"max_error_vs_blend565\": %d}\n",
+            blend_check.checked, blend_check.wrong, blend_check.max_error);
+    fprintf(out, "}\n");
+    if (out != stdout) fclose(out);
+
+    return all_same && !blend_check.wrong ? 0 : 1;
+}
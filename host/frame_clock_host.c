@@ -0,0 +1,31 @@
+#include "frame_clock.h"
+
+// Virtual clock: time only moves when the caller says so, which makes
+// scheduler runs on the host deterministic
+
+static uint32_t ticks = 0;
+static volatile int wakeup = 0;
+
+void frame_clock_start(uint32_t period_us)
+{
+    (void)period_us;
+    ticks = 0;
+    wakeup = 0;
+}
+
+uint32_t frame_clock_now(void)
+{
+    return ticks;
+}
+
+volatile int *frame_clock_wakeup(void)
+{
+    wakeup = 0;
+    return &wakeup;
+}
+
+void frame_clock_advance(uint32_t n)
+{
+    ticks += n;
+    if (n) wakeup = 1;
+}
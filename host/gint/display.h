@@ -0,0 +1,24 @@
+#ifndef HOST_GINT_DISPLAY_H
+#define HOST_GINT_DISPLAY_H
+
+// Host stand-in for the parts of gint's display API used by the drawing
+// code, backed by in-memory fx-CG50 VRAMs and LCD (gint_host.c)
+
+#include <stdint.h>
+
+#define DWIDTH 396
+#define DHEIGHT 224
+
+extern uint16_t *gint_vram;
+
+void dclear(uint16_t color);
+void dpixel(int x, int y, int color);
+// Rectangle with inclusive corners, clipped like gint's
+void drect(int x1, int y1, int x2, int y2, int color);
+void dline(int x1, int y1, int x2, int y2, int color);
+// Copy the VRAM to the (host) LCD
+void dupdate(void);
+void dgetvram(uint16_t **main, uint16_t **secondary);
+void dsetvram(uint16_t *main, uint16_t *secondary);
+
+#endif // HOST_GINT_DISPLAY_H
@@ -0,0 +1,11 @@
+#ifndef HOST_GINT_DRIVERS_R61524_H
+#define HOST_GINT_DRIVERS_R61524_H
+
+// Host stand-in for the fx-CG50 display driver (gint_host.c)
+
+#include <stdint.h>
+
+// Push the window [xmin, xmax] x [ymin, ymax] (inclusive) of vram to the LCD
+void r61524_display_rect(uint16_t *vram, int xmin, int xmax, int ymin, int ymax);
+
+#endif // HOST_GINT_DRIVERS_R61524_H
@@ -0,0 +1,12 @@
+#ifndef HOST_GINT_GINT_H
+#define HOST_GINT_GINT_H
+
+// Host stand-in for gint's returns to the OS: there is no OS to return
+// to, so both come straight back (keyboard_host.c)
+
+#include <stdbool.h>
+
+void gint_osmenu(void);
+void gint_poweroff(bool show_logo);
+
+#endif // HOST_GINT_GINT_H
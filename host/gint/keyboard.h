@@ -0,0 +1,38 @@
+#ifndef HOST_GINT_KEYBOARD_H
+#define HOST_GINT_KEYBOARD_H
+
+// Host stand-in for the parts of gint's keyboard API used by the input
+// handler: a scripted event queue filled with host_press_key() and
+// host_release_key() (gint_host.h, keyboard_host.c)
+
+#include <stdint.h>
+
+enum {
+    KEYEV_NONE = 0,
+    KEYEV_DOWN,
+    KEYEV_UP,
+    KEYEV_HOLD,
+};
+
+// Key codes; only distinct values matter on the host
+enum {
+    KEY_F1 = 0x91, KEY_F2, KEY_F3, KEY_F4, KEY_F5, KEY_F6,
+    KEY_SHIFT = 0x81, KEY_OPTN = 0x82, KEY_MENU = 0x84, KEY_ACON = 0x07,
+    KEY_LEFT = 0x85, KEY_UP = 0x86, KEY_DOWN = 0x75, KEY_RIGHT = 0x76,
+    KEY_EXIT = 0x47, KEY_EXE = 0x14,
+};
+
+typedef struct {
+    uint16_t time;
+    uint8_t type;
+    uint8_t key;
+} key_event_t;
+
+// Next queued event, or a KEYEV_NONE event when the queue is empty
+key_event_t pollevent(void);
+// Like pollevent(): a script never has to be waited for
+key_event_t waitevent(volatile int *timeout);
+// Whether the key is down after the events read so far
+int keydown(int key);
+
+#endif // HOST_GINT_KEYBOARD_H
@@ -0,0 +1,149 @@
+#include <gint/display.h>
+#include <gint/drivers/r61524.h>
+#include <string.h>
+#include "gint_host.h"
+
+// Two VRAMs like gint's defaults, plus the LCD that dupdate() writes to
+static uint16_t host_vram[2][DWIDTH * DHEIGHT];
+static uint16_t lcd[DWIDTH * DHEIGHT];
+static uint16_t *vram_main = host_vram[0];
+static uint16_t *vram_secondary = host_vram[1];
+static long updates = 0;
+static uint64_t lcd_pixels = 0;
+
+uint16_t *gint_vram = host_vram[0];
+
+void dclear(uint16_t color)
+{
+    for (int i = 0; i < DWIDTH * DHEIGHT; i++) gint_vram[i] = color;
+}
+
+void dpixel(int x, int y, int color)
+{
+    // Same bounds check as gint
+    if ((unsigned)x >= DWIDTH || (unsigned)y >= DHEIGHT) return;
+    gint_vram[y * DWIDTH + x] = (uint16_t)color;
+}
+
+void drect(int x1, int y1, int x2, int y2, int color)
+{
+    if (x1 > x2) { int t = x1; x1 = x2; x2 = t; }
+    if (y1 > y2) { int t = y1; y1 = y2; y2 = t; }
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 >= DWIDTH) x2 = DWIDTH - 1;
+    if (y2 >= DHEIGHT) y2 = DHEIGHT - 1;
+
+    for (int y = y1; y <= y2; y++)
+    {
+        for (int x = x1; x <= x2; x++) gint_vram[y * DWIDTH + x] = (uint16_t)color;
+    }
+}
+
+void dline(int x1, int y1, int x2, int y2, int color)
+{
+    // Bresenham, every point clipped by dpixel
+    int dx = x2 > x1 ? x2 - x1 : x1 - x2;
+    int dy = y2 > y1 ? y1 - y2 : y2 - y1;
+    int sx = x1 < x2 ? 1 : -1;
+    int sy = y1 < y2 ? 1 : -1;
+    int err = dx + dy;
+
+    while (1)
+    {
+        dpixel(x1, y1, color);
+        if (x1 == x2 && y1 == y2) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x1 += sx; }
+        if (e2 <= dx) { err += dx; y1 += sy; }
+    }
+}
+
+void dupdate(void)
+{
+    memcpy(lcd, gint_vram, sizeof(lcd));
+    updates++;
+    lcd_pixels += DWIDTH * DHEIGHT;
+    // Triple buffering is not modelled: flip only when two VRAMs are set
+    if (vram_main != vram_secondary)
+    {
+        uint16_t *t = vram_main;
+        vram_main = vram_secondary;
+        vram_secondary = t;
+        gint_vram = vram_main;
+    }
+}
+
+void r61524_display_rect(uint16_t *vram, int xmin, int xmax, int ymin, int ymax)
+{
+    if (xmin < 0) xmin = 0;
+    if (ymin < 0) ymin = 0;
+    if (xmax >= DWIDTH) xmax = DWIDTH - 1;
+    if (ymax >= DHEIGHT) ymax = DHEIGHT - 1;
+    if (xmin > xmax || ymin > ymax) return;
+
+    for (int y = ymin; y <= ymax; y++)
+    {
+        memcpy(lcd + y * DWIDTH + xmin, vram + y * DWIDTH + xmin, (size_t)(xmax - xmin + 1) * sizeof(uint16_t));
+    }
+    updates++;
+    lcd_pixels += (uint64_t)(xmax - xmin + 1) * (uint64_t)(ymax - ymin + 1);
+}
+
+void dgetvram(uint16_t **main, uint16_t **secondary)
+{
+    if (main) *main = host_vram[0];
+    if (secondary) *secondary = host_vram[1];
+}
+
+void dsetvram(uint16_t *main, uint16_t *secondary)
+{
+    vram_main = main;
+    vram_secondary = secondary;
+    gint_vram = main;
+}
+
+const uint16_t *host_lcd(void)
+{
+    return lcd;
+}
+
+long host_update_count(void)
+{
+    return updates;
+}
+
+uint64_t host_lcd_pixels(void)
+{
+    return lcd_pixels;
+}
+
+uint64_t host_frame_hash(const uint16_t *frame)
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (int i = 0; i < DWIDTH * DHEIGHT; i++)
+    {
+        h ^= frame[i] & 0xFF;
+        h *= 0x100000001b3ull;
+        h ^= frame[i] >> 8;
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+int host_write_ppm(FILE *fp, const uint16_t *frame)
+{
+    fprintf(fp, "P6\n%d %d\n255\n", DWIDTH, DHEIGHT);
+    for (int i = 0; i < DWIDTH * DHEIGHT; i++)
+    {
+        uint16_t c = frame[i];
+        // Expand 5/6/5 bits to 8 by repeating the top bits
+        unsigned char rgb[3] = {
+            (unsigned char)(((c >> 11) << 3) | (c >> 13)),
+            (unsigned char)((((c >> 5) & 0x3F) << 2) | ((c >> 9) & 0x03)),
+            (unsigned char)(((c & 0x1F) << 3) | ((c >> 2) & 0x07)),
+        };
+        if (fwrite(rgb, 1, 3, fp) != 3) return 0;
+    }
+    return 1;
+}
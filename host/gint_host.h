@@ -0,0 +1,24 @@
+#ifndef GINT_HOST_H
+#define GINT_HOST_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Host-side access to the gint display stand-in (gint_host.c)
+
+// Pixels last pushed by dupdate(), DWIDTH x DHEIGHT RGB565
+const uint16_t *host_lcd(void);
+// Number of dupdate() and r61524_display_rect() calls so far
+long host_update_count(void);
+// Pixels sent to the LCD by them so far (2 bytes each)
+uint64_t host_lcd_pixels(void);
+// FNV-1a 64 over a DWIDTH x DHEIGHT frame, for golden-frame comparisons
+uint64_t host_frame_hash(const uint16_t *frame);
+// Write a frame as binary PPM (P6, 8 bits per channel); returns 0 on error
+int host_write_ppm(FILE *fp, const uint16_t *frame);
+
+// Queue a key press or release for pollevent() (keyboard_host.c)
+void host_press_key(int key);
+void host_release_key(int key);
+
+#endif // GINT_HOST_H
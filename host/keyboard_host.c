@@ -0,0 +1,60 @@
+#include <gint/keyboard.h>
+#include <gint/gint.h>
+#include "gint_host.h"
+
+// Scripted key events, read back in order by pollevent()
+#define QUEUE_SIZE 256
+
+static key_event_t queue[QUEUE_SIZE];
+static int head = 0, tail = 0;
+static uint8_t down[256];
+
+static void push(int type, int key)
+{
+    int next = (tail + 1) % QUEUE_SIZE;
+    if (next == head) return;  // full: the event is lost, as on gint
+    queue[tail].time = 0;
+    queue[tail].type = (uint8_t)type;
+    queue[tail].key = (uint8_t)key;
+    tail = next;
+}
+
+void host_press_key(int key)
+{
+    push(KEYEV_DOWN, key);
+}
+
+void host_release_key(int key)
+{
+    push(KEYEV_UP, key);
+}
+
+key_event_t pollevent(void)
+{
+    key_event_t ev = { 0, KEYEV_NONE, 0 };
+    if (head == tail) return ev;
+    ev = queue[head];
+    head = (head + 1) % QUEUE_SIZE;
+    down[ev.key] = ev.type != KEYEV_UP;
+    return ev;
+}
+
+key_event_t waitevent(volatile int *timeout)
+{
+    (void)timeout;
+    return pollevent();
+}
+
+int keydown(int key)
+{
+    return down[key & 0xFF];
+}
+
+void gint_osmenu(void)
+{
+}
+
+void gint_poweroff(bool show_logo)
+{
+    (void)show_logo;
+}
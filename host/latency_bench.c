@@ -0,0 +1,337 @@
+// Key-to-display latency benchmark: plays seeded games by pressing keys
+// into the keyboard stand-in, one frame at a time, through the add-in's
+// event loop (input_poll_frame, so input_handle_key and
+// input_process_action), scheduler and renderer, and reports the
+// input_latency histogram as p50/p95/p99 in microseconds. The key sequence
+// only depends on --seed, so runs on different commits replay the same keys.
+// --record FILE appends the games to a replay file (replay.h). Before
+// timing, it checks that folding a frame's moves (game_state_move_path)
+// ends where the same moves one at a time do, which replays rely on
+//
+//   blockblast-latency [--keys N] [--seed S] [--out FILE] [--dump FILE] [--record FILE]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <gint/keyboard.h>
+#include "gint_host.h"
+#include "selfplay.h"
+#include "game_state.h"
+#include "grid.h"
+#include "tetris_blocks.h"
+#include "piece_catalog.h"
+#include "input_handler.h"
+#include "input_latency.h"
+#include "renderer.h"
+#include "frame_sched.h"
+#include "frame_clock.h"
+#include "particles.h"
+#include "profiler.h"
+#include "replay.h"
+#include "score.h"
+
+#ifndef BENCH_GIT_REV
+#define BENCH_GIT_REV "unknown"
+#endif
+
+// Frames a turn may take before the player gives up on its target
+#define TURN_FRAMES_MAX 64
+
+typedef struct {
+    selfplay_rng_t rng;
+    int browse;      // random sidebar moves before the next pick, -1 for the next slot
+    int has_target;
+    int x, y;
+    int turn;
+    int turn_frames;
+    long keys;
+    long games;
+} player_t;
+
+static const char *record_path = NULL;
+
+static void press(player_t *p, int key)
+{
+    host_press_key(key);
+    host_release_key(key);
+    p->keys++;
+}
+
+static void new_game(player_t *p)
+{
+    uint32_t seed = (uint32_t)selfplay_rng_next(&p->rng);
+    if (record_path)
+    {
+        // Recorded through the event loop's own hooks, like on the add-in
+        replay_record_save(record_path, (uint32_t)score_get_current());
+        replay_record_start(seed);
+    }
+    game_state_reset(seed);
+    particles_clear();
+    renderer_redraw_all();
+    p->has_target = 0;
+    p->turn_frames = 0;
+    p->games++;
+}
+
+// Random legal spot for the active block, picked like selfplay_choose_move;
+// returns 0 if there is none
+static int choose_target(player_t *p, int piece_type)
+{
+    uint64_t anchors = piece_catalog_free_anchors(piece_type, grid_get_occupancy_ctx(game_ctx_default()));
+    int count = __builtin_popcountll(anchors);
+    if (!count) return 0;
+
+    int pick = (int)(selfplay_rng_next(&p->rng) % (uint64_t)count);
+    for (int i = 0; i < pick; i++) anchors &= anchors - 1;
+    int bit = __builtin_ctzll(anchors);
+    const piece_info_t *info = piece_catalog_get(piece_type);
+    p->x = bit % GRID_SIZE - info->box_col;
+    p->y = bit / GRID_SIZE - info->box_row;
+    return 1;
+}
+
+// Keys of the next frame: browse the sidebar with 0 to 2 keys, pick the
+// selected piece, steer it to a random legal spot with bursts of 1 to 3
+// arrows (folded into one move by the event loop) and lock it
+static void script_frame(player_t *p)
+{
+    const placed_block_t *active = grid_get_active_placed_block();
+    if (++p->turn_frames > TURN_FRAMES_MAX)
+    {
+        // The piece that fits may be out of reach: moving up onto an empty
+        // slot skips forward again, so start over
+        new_game(p);
+        return;
+    }
+
+    if (!active)
+    {
+        if (p->browse < 0)
+        {
+            press(p, tetris_blocks_get_selection() < 2 ? KEY_DOWN : KEY_UP);
+            p->browse = 0;
+        }
+        else if (p->browse > 0)
+        {
+            // Two sidebar keys in one frame now and then, folded by the
+            // event loop like arrows on an active block
+            int burst = p->browse > 1 && selfplay_rng_next(&p->rng) % 2 ? 2 : 1;
+            for (int i = 0; i < burst; i++) press(p, selfplay_rng_next(&p->rng) % 2 ? KEY_DOWN : KEY_UP);
+            p->browse -= burst;
+        }
+        else
+        {
+            press(p, KEY_EXE);
+        }
+        return;
+    }
+
+    if (!p->has_target && !(p->has_target = choose_target(p, active->piece_type)))
+    {
+        // Does not fit anywhere: put it back and take the next one
+        press(p, KEY_EXIT);
+        p->browse = -1;
+        return;
+    }
+
+    int dx = p->x - active->grid_x, dy = p->y - active->grid_y;
+    if (!dx && !dy)
+    {
+        press(p, KEY_EXE);
+        p->has_target = 0;
+        p->turn++;
+        p->turn_frames = 0;
+        p->browse = (int)(selfplay_rng_next(&p->rng) % 3);
+        return;
+    }
+    int burst = 1 + p->turn % 3;
+    for (int i = 0; i < burst && (dx || dy); i++)
+    {
+        if (dx)
+        {
+            press(p, dx > 0 ? KEY_RIGHT : KEY_LEFT);
+            dx += dx > 0 ? -1 : 1;
+        }
+        else
+        {
+            press(p, dy > 0 ? KEY_DOWN : KEY_UP);
+            dy += dy > 0 ? -1 : 1;
+        }
+    }
+}
+
+// --- Folded moves against moves one at a time ---
+
+#define MOVE_CHECK_MAX_STEPS 4
+#define MOVE_CHECK_ACTIVE_TRIES 2000
+
+// Apply steps both ways on copies of ctx; returns 1 if they end the same
+static int same_move_end(const game_ctx_t *ctx, const int8_t *dx, const int8_t *dy, int n)
+{
+    static game_ctx_t stepped, folded;
+    stepped = *ctx;
+    folded = *ctx;
+    for (int i = 0; i < n; i++) game_state_move_ctx(&stepped, dx[i], dy[i]);
+    game_state_move_path_ctx(&folded, dx, dy, n);
+
+    const placed_block_t *a = grid_get_active_placed_block_ctx(&stepped);
+    const placed_block_t *b = grid_get_active_placed_block_ctx(&folded);
+    if (!a != !b) return 0;
+    if (a && (a->grid_x != b->grid_x || a->grid_y != b->grid_y)) return 0;
+    return tetris_blocks_get_selection_ctx(&stepped) == tetris_blocks_get_selection_ctx(&folded);
+}
+
+// Every sidebar with empty slots, every selection and every up/down path of
+// up to MOVE_CHECK_MAX_STEPS steps, then random arrow paths of an active
+// block; returns the number of cases that differ
+static long check_move_paths(long *cases)
+{
+    static game_ctx_t ctx;
+    int8_t dx[INPUT_MAX_STEPS], dy[INPUT_MAX_STEPS];
+    long bad = 0;
+    *cases = 0;
+
+    for (int filled = 0; filled < 8; filled++)
+    {
+        for (int selection = 0; selection < 3; selection++)
+        {
+            for (int n = 1; n <= MOVE_CHECK_MAX_STEPS; n++)
+            {
+                for (int path = 0; path < 1 << n; path++)
+                {
+                    game_ctx_init(&ctx, 1);
+                    for (int s = 0; s < 3; s++)
+                    {
+                        if (!(filled >> s & 1)) ctx.blocks.stored_pieces[s] = -1;
+                    }
+                    ctx.blocks.selected_block = selection;
+                    for (int i = 0; i < n; i++)
+                    {
+                        dx[i] = 0;
+                        dy[i] = path >> i & 1 ? 1 : -1;
+                    }
+                    bad += !same_move_end(&ctx, dx, dy, n);
+                    (*cases)++;
+                }
+            }
+        }
+    }
+
+    selfplay_rng_t rng;
+    selfplay_rng_seed(&rng, 7);
+    for (int t = 0; t < MOVE_CHECK_ACTIVE_TRIES; t++)
+    {
+        game_ctx_init(&ctx, (uint32_t)selfplay_rng_next(&rng));
+        if (!game_state_pick_selected_ctx(&ctx)) continue;
+        int n = 1 + (int)(selfplay_rng_next(&rng) % INPUT_MAX_STEPS);
+        for (int i = 0; i < n; i++)
+        {
+            int dir = (int)(selfplay_rng_next(&rng) % 4);
+            dx[i] = dir == 0 ? -1 : dir == 1 ? 1 : 0;
+            dy[i] = dir == 2 ? -1 : dir == 3 ? 1 : 0;
+        }
+        bad += !same_move_end(&ctx, dx, dy, n);
+        (*cases)++;
+    }
+    return bad;
+}
+
+static void run(player_t *p, long keys, long *frames)
+{
+    while (p->keys < keys)
+    {
+        if (game_state_is_over()) new_game(p);
+
+        // Odd turns let the sweep finish, even ones press on and cut it short
+        if (!(frame_sched_busy() && p->turn % 2)) script_frame(p);
+
+        // One iteration of the add-in's main loop
+        frame_clock_advance(1);
+        input_poll_frame();
+        frame_sched_update();
+        renderer_present();
+        (*frames)++;
+    }
+}
+
+static double us(uint64_t ns)
+{
+    return (double)ns / 1000.0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *out_path = NULL, *dump_path = NULL;
+    long keys = 20000;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        int has_value = i + 1 < argc;
+        if (!strcmp(arg, "--keys") && has_value) keys = atol(argv[++i]);
+        else if (!strcmp(arg, "--seed") && has_value) seed = strtoull(argv[++i], NULL, 0);
+        else if (!strcmp(arg, "--out") && has_value) out_path = argv[++i];
+        else if (!strcmp(arg, "--dump") && has_value) dump_path = argv[++i];
+        else if (!strcmp(arg, "--record") && has_value) record_path = argv[++i];
+        else
+        {
+            fprintf(stderr, "usage: %s [--keys N] [--seed S] [--out FILE] [--dump FILE] [--record FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (keys <= 0) keys = 1;
+
+    long move_cases;
+    long move_mismatches = check_move_paths(&move_cases);
+
+    player_t player;
+    memset(&player, 0, sizeof(player));
+    selfplay_rng_seed(&player.rng, seed);
+
+    renderer_init();
+    frame_sched_init();
+    profiler_init();
+    input_latency_reset();
+    new_game(&player);
+    player.games = 0;
+
+    long frames = 0;
+    run(&player, keys, &frames);
+    if (record_path)
+    {
+        // Score the last placement as a key press would
+        grid_skip_line_clear();
+        replay_record_save(record_path, (uint32_t)score_get_current());
+    }
+
+    if (dump_path && !input_latency_dump(dump_path))
+    {
+        perror(dump_path);
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (out_path && !(out = fopen(out_path, "w")))
+    {
+        perror(out_path);
+        return 1;
+    }
+    const latency_hist_t *hist = input_latency_hist();
+    fprintf(out, "{\n");
+    fprintf(out, "  \"benchmark\": \"latency\",\n");
+    fprintf(out, "  \"git_rev\": \"%s\",\n", BENCH_GIT_REV);
+    fprintf(out, "  \"seed\": %llu,\n", (unsigned long long)seed);
+    fprintf(out, "  \"keys\": %llu, \"frames\": %ld, \"games\": %ld,\n",
+            (unsigned long long)hist->count, frames, player.games);
+    fprintf(out, "  \"key_to_display_us\": {\"p50\": %.2f, \"p95\": %.2f, \"p99\": %.2f, "
+                 "\"mean\": %.2f, \"max\": %.2f},\n",
+            us(latency_hist_quantile(hist, 0.50)), us(latency_hist_quantile(hist, 0.95)),
+            us(latency_hist_quantile(hist, 0.99)), latency_hist_mean(hist) / 1000.0, us(hist->max));
+    fprintf(out, "  \"lcd_updates\": %ld, \"lcd_bytes\": %llu,\n", host_update_count(),
+            (unsigned long long)(2 * host_lcd_pixels()));
+    fprintf(out, "  \"move_path\": {\"cases\": %ld, \"mismatches\": %ld}\n", move_cases, move_mismatches);
+    fprintf(out, "}\n");
+    if (out != stdout) fclose(out);
+    return move_mismatches ? 1 : 0;
+}
@@ -0,0 +1,46 @@
+#include <time.h>
+#include "profiler.h"
+
+// Section timings from the monotonic clock, in nanoseconds until taken
+
+static uint64_t started[PROF_SECTION_COUNT];
+static uint64_t elapsed[PROF_SECTION_COUNT];
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void profiler_init(void)
+{
+    for (int i = 0; i < PROF_SECTION_COUNT; i++) elapsed[i] = 0;
+}
+
+void profiler_enter(prof_section_t section)
+{
+    started[section] = now_ns();
+}
+
+void profiler_leave(prof_section_t section)
+{
+    elapsed[section] += now_ns() - started[section];
+}
+
+uint32_t profiler_take_us(prof_section_t section)
+{
+    uint32_t us = (uint32_t)(elapsed[section] / 1000);
+    elapsed[section] = 0;
+    return us;
+}
+
+profiler_stamp_t profiler_stamp(void)
+{
+    return now_ns();
+}
+
+uint64_t profiler_since_ns(profiler_stamp_t stamp)
+{
+    return now_ns() - stamp;
+}
@@ -0,0 +1,466 @@
+// Headless renderer runs: plays scripted scenes through the add-in's
+// renderer on the host display stand-in, hashes every frame it pushes and
+// compares the hashes with a golden list, so drawing optimizations can be
+// checked pixel for pixel; --bench also times full redraws, the line clear
+// animation and the sidebar, and how many pixels cursor moves send to the
+// LCD. PROFILER builds also take --profile FILE, which
+// writes the profiler's per-frame section timings as CSV
+//
+//   blockblast-render [--check FILE | --write FILE] [--dump DIR] [--bench] [--frames N] [--out FILE]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <gint/display.h>
+#include "gint_host.h"
+#include "latency_hist.h"
+#include "selfplay.h"
+#include "game_state.h"
+#include "grid.h"
+#include "tetris_blocks.h"
+#include "renderer.h"
+#include "frame_sched.h"
+#include "frame_clock.h"
+#include "particles.h"
+#include "background.h"
+#include "profiler.h"
+
+#ifndef BENCH_GIT_REV
+#define BENCH_GIT_REV "unknown"
+#endif
+
+#define MAX_FRAMES 128
+#define FRAME_NAME_LEN 32
+
+typedef struct {
+    char name[FRAME_NAME_LEN];
+    uint64_t hash;
+} golden_frame_t;
+
+static golden_frame_t frames[MAX_FRAMES];
+static int num_frames = 0;
+static const char *dump_dir = NULL;
+
+// Record the frame on the LCD under `name`
+static void capture(const char *name)
+{
+    if (num_frames >= MAX_FRAMES) return;
+    golden_frame_t *f = &frames[num_frames++];
+    snprintf(f->name, sizeof(f->name), "%s", name);
+    f->hash = host_frame_hash(host_lcd());
+
+    if (!dump_dir) return;
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.ppm", dump_dir, name);
+    FILE *fp = fopen(path, "wb");
+    if (!fp || !host_write_ppm(fp, host_lcd())) perror(path);
+    if (fp) fclose(fp);
+}
+
+// --- Scenes, played on game_ctx_default() like the add-in ---
+
+static void finish_turn(void)
+{
+    game_state_finish_turn();
+    game_state_check_game_over();
+}
+
+// Pick the piece of `slot` up, move it to (x, y) and lock it the way the
+// input handler does; the line clear sweep is left to the scheduler
+static void place(int slot, int x, int y)
+{
+    tetris_blocks_set_selection(slot);
+    if (!game_state_pick_selected()) return;
+    const placed_block_t *active = grid_get_active_placed_block();
+    game_state_move(x - active->grid_x, y - active->grid_y);
+    if (game_state_place_active() >= 0) grid_start_line_clear(finish_turn);
+}
+
+// Advance the virtual clock one tick and present the frame
+static void tick(void)
+{
+    frame_clock_advance(1);
+    frame_sched_update();
+    renderer_present();
+}
+
+static void play_random_turn(selfplay_rng_t *rng)
+{
+    int slot, x, y;
+    if (!selfplay_choose_move(game_ctx_default(), rng, &slot, &x, &y))
+    {
+        game_state_check_game_over();
+        return;
+    }
+    place(slot, x, y);
+    grid_skip_line_clear();
+}
+
+// First legal move that completes a line; returns 0 if there is none
+static int find_clearing_move(int *slot, int *x, int *y)
+{
+    for (int s = 0; s < 3; s++)
+    {
+        int piece_type = tetris_blocks_get_piece_type_for_selection(s);
+        if (piece_type < 0) continue;
+        for (*y = 0; *y < GRID_SIZE; (*y)++)
+        {
+            for (*x = 0; *x < GRID_SIZE; (*x)++)
+            {
+                if (grid_can_place(piece_type, *x, *y) && grid_would_clear_lines(piece_type, *x, *y))
+                {
+                    *slot = s;
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+// Play until a line clear is possible and set it up without locking it
+static void reach_line_clear(selfplay_rng_t *rng, int *slot, int *x, int *y)
+{
+    while (!find_clearing_move(slot, x, y))
+    {
+        if (game_state_is_over()) game_state_reset((uint32_t)selfplay_rng_next(rng));
+        play_random_turn(rng);
+    }
+}
+
+// Run the animations to the end, presenting one frame per tick; returns
+// the number of frames
+static int play_animation(const char *name)
+{
+    int n = 0;
+    while (frame_sched_busy())
+    {
+        tick();
+        if (name)
+        {
+            char frame_name[FRAME_NAME_LEN];
+            snprintf(frame_name, sizeof(frame_name), "%s.%02d", name, n);
+            capture(frame_name);
+        }
+        n++;
+    }
+    return n;
+}
+
+static void draw_game_over_screen(void)
+{
+    // As in main.c
+    background_draw();
+    grid_draw_placed_blocks();
+    grid_draw_score();
+    renderer_draw_game_over();
+    renderer_draw_footer();
+    dupdate();
+    renderer_invalidate();
+}
+
+static void run_scenes(void)
+{
+    selfplay_rng_t rng;
+    selfplay_rng_seed(&rng, 1);
+
+    renderer_init();
+    frame_sched_init();
+    particles_clear();
+    game_state_reset(1);
+    renderer_redraw_all();
+    capture("start");
+
+    game_state_move(0, 1);
+    renderer_present();
+    capture("select");
+
+    game_state_pick_selected();
+    game_state_move(3, 2);
+    renderer_present();
+    capture("active");
+
+    // Partial LCD pushes: the LCD must match a full repaint after each move
+    static const int moves[4][2] = { { 1, 0 }, { 0, 1 }, { 1, 1 }, { -1, 0 } };
+    for (int i = 0; i < 4; i++)
+    {
+        char name[FRAME_NAME_LEN];
+        game_state_move(moves[i][0], moves[i][1]);
+        renderer_present();
+        snprintf(name, sizeof(name), "move.%d", i);
+        capture(name);
+    }
+
+    game_state_cancel_active();
+    renderer_present();
+    capture("cancel");
+
+    for (int i = 0; i < 12 && !game_state_is_over(); i++) play_random_turn(&rng);
+    renderer_present();
+    capture("midgame");
+
+    int slot, x, y;
+    reach_line_clear(&rng, &slot, &x, &y);
+    renderer_present();
+    place(slot, x, y);
+    play_animation("line_clear");
+
+    while (!game_state_is_over()) play_random_turn(&rng);
+    draw_game_over_screen();
+    capture("game_over");
+}
+
+#ifdef PROFILER
+static FILE *profile_out = NULL;
+static long profile_frame = 0;
+
+// Frame hook: one CSV row of microseconds per section
+static void write_profile_row(const uint32_t *us)
+{
+    fprintf(profile_out, "%ld", profile_frame++);
+    for (int i = 0; i < PROF_SECTION_COUNT; i++) fprintf(profile_out, ",%u", us[i]);
+    fprintf(profile_out, "\n");
+}
+
+static int start_profile(const char *path)
+{
+    if (!(profile_out = fopen(path, "w")))
+    {
+        perror(path);
+        return 0;
+    }
+    fprintf(profile_out, "frame");
+    for (int i = 0; i < PROF_SECTION_COUNT; i++)
+    {
+        fprintf(profile_out, ",%s_us", profiler_section_name((prof_section_t)i));
+    }
+    fprintf(profile_out, "\n");
+    profiler_init();
+    profiler_set_frame_hook(write_profile_row);
+    return 1;
+}
+#endif
+
+// --- Golden list: one "name hash" line per frame ---
+
+static int write_golden(const char *path)
+{
+    FILE *fp = fopen(path, "w");
+    if (!fp)
+    {
+        perror(path);
+        return 0;
+    }
+    for (int i = 0; i < num_frames; i++)
+    {
+        fprintf(fp, "%s %016llx\n", frames[i].name, (unsigned long long)frames[i].hash);
+    }
+    fclose(fp);
+    return 1;
+}
+
+// Returns the number of mismatched or missing frames, or -1 on error
+static int check_golden(const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+    {
+        perror(path);
+        return -1;
+    }
+
+    int bad = 0, seen = 0;
+    char name[FRAME_NAME_LEN];
+    unsigned long long hash;
+    while (fscanf(fp, "%31s %llx", name, &hash) == 2)
+    {
+        int found = 0;
+        for (int i = 0; i < num_frames; i++)
+        {
+            if (strcmp(frames[i].name, name)) continue;
+            found = 1;
+            if (frames[i].hash != hash)
+            {
+                printf("%s: %016llx, expected %016llx\n", name, (unsigned long long)frames[i].hash, hash);
+                bad++;
+            }
+        }
+        if (!found)
+        {
+            printf("%s: not rendered\n", name);
+            bad++;
+        }
+        seen++;
+    }
+    fclose(fp);
+
+    if (seen != num_frames)
+    {
+        printf("%d frames rendered, %d in %s\n", num_frames, seen, path);
+        bad++;
+    }
+    return bad;
+}
+
+// --- Benchmark ---
+
+static void bench_redraw(void)
+{
+    renderer_redraw_all();
+}
+
+static void bench_sidebar(void)
+{
+    tetris_blocks_draw();
+}
+
+static uint64_t time_ns(void (*draw)(void), long n)
+{
+    uint64_t start = latency_now_ns();
+    for (long i = 0; i < n; i++) draw();
+    return latency_now_ns() - start;
+}
+
+static double per_second(long n, uint64_t ns)
+{
+    return ns ? (double)n * 1e9 / (double)ns : 0.0;
+}
+
+static void run_bench(FILE *out, long n)
+{
+    selfplay_rng_t rng;
+    selfplay_rng_seed(&rng, 2);
+    game_state_reset(2);
+    for (int i = 0; i < 12 && !game_state_is_over(); i++) play_random_turn(&rng);
+    int slot, x, y;
+    reach_line_clear(&rng, &slot, &x, &y);
+    renderer_redraw_all();
+    game_ctx_t before_clear = *game_ctx_default();
+
+    uint64_t redraw_ns = time_ns(bench_redraw, n);
+    uint64_t sidebar_ns = time_ns(bench_sidebar, n);
+
+    // The whole animation, from the same position every time
+    long anims = n / 20 > 0 ? n / 20 : 1;
+    long anim_frames = 0;
+    uint64_t anim_ns = 0;
+    for (long i = 0; i < anims; i++)
+    {
+        *game_ctx_default() = before_clear;
+        particles_clear();
+        renderer_redraw_all();
+        uint64_t start = latency_now_ns();
+        place(slot, x, y);
+        anim_frames += play_animation(NULL);
+        anim_ns += latency_now_ns() - start;
+    }
+
+    // Cursor moves of an active block, each pushing only what it repainted
+    *game_ctx_default() = before_clear;
+    renderer_redraw_all();
+    game_state_pick_selected();
+    renderer_present();
+    static const int moves[4][2] = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } };
+    long move_frames = 0;
+    uint64_t move_pixels = host_lcd_pixels();
+    uint64_t move_ns = 0;
+    for (long i = 0; i < n; i++)
+    {
+        const int *m = moves[selfplay_rng_next(&rng) % 4];
+        uint64_t start = latency_now_ns();
+        game_state_move(m[0], m[1]);
+        move_frames += renderer_present();
+        move_ns += latency_now_ns() - start;
+    }
+    move_pixels = host_lcd_pixels() - move_pixels;
+    double move_fraction = move_frames ? (double)move_pixels / move_frames / (DWIDTH * DHEIGHT) : 0.0;
+
+    frame_sched_stats_t stats;
+    frame_sched_get_stats(&stats);
+    fprintf(out, "{\n");
+    fprintf(out, "  \"benchmark\": \"render\",\n");
+    fprintf(out, "  \"git_rev\": \"%s\",\n", BENCH_GIT_REV);
+    fprintf(out, "  \"frames\": %ld,\n", n);
+    fprintf(out, "  \"redraw_all\": {\"ns_per_frame\": %.1f, \"fps\": %.1f},\n",
+            (double)redraw_ns / n, per_second(n, redraw_ns));
+    fprintf(out, "  \"sidebar\": {\"ns_per_frame\": %.1f, \"fps\": %.1f},\n",
+            (double)sidebar_ns / n, per_second(n, sidebar_ns));
+    fprintf(out, "  \"line_clear\": {\"animations\": %ld, \"frames\": %ld, \"ns_per_frame\": %.1f, \"fps\": %.1f},\n",
+            anims, anim_frames, anim_frames ? (double)anim_ns / anim_frames : 0.0,
+            per_second(anim_frames, anim_ns));
+    fprintf(out, "  \"cursor_moves\": {\"frames\": %ld, \"ns_per_frame\": %.1f, \"lcd_bytes_per_frame\": %.0f, "
+                 "\"screen_fraction\": %.3f},\n",
+            move_frames, move_frames ? (double)move_ns / move_frames : 0.0,
+            move_frames ? 2.0 * (double)move_pixels / move_frames : 0.0, move_fraction);
+    fprintf(out, "  \"scheduler\": {\"steps\": %u, \"missed\": %u},\n", stats.steps, stats.missed);
+    fprintf(out, "  \"lcd_updates\": %ld, \"lcd_bytes\": %llu\n", host_update_count(),
+            (unsigned long long)(2 * host_lcd_pixels()));
+    fprintf(out, "}\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *check_path = NULL, *write_path = NULL, *out_path = NULL;
+    int bench = 0;
+    long n = 2000;
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        int has_value = i + 1 < argc;
+        if (!strcmp(arg, "--check") && has_value) check_path = argv[++i];
+        else if (!strcmp(arg, "--write") && has_value) write_path = argv[++i];
+        else if (!strcmp(arg, "--dump") && has_value) dump_dir = argv[++i];
+        else if (!strcmp(arg, "--frames") && has_value) n = atol(argv[++i]);
+        else if (!strcmp(arg, "--out") && has_value) out_path = argv[++i];
+        else if (!strcmp(arg, "--bench")) bench = 1;
+#ifdef PROFILER
+        else if (!strcmp(arg, "--profile") && has_value)
+        {
+            if (!start_profile(argv[++i])) return 1;
+        }
+#endif
+        else
+        {
+            fprintf(stderr, "usage: %s [--check FILE | --write FILE] [--dump DIR] [--bench] "
+                            "[--frames N] [--out FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (n <= 0) n = 1;
+
+    // Scenes first, from a fresh process state, so the hashes do not depend
+    // on the other options
+    run_scenes();
+
+    int status = 0;
+    if (write_path && !write_golden(write_path)) status = 1;
+    if (check_path)
+    {
+        int bad = check_golden(check_path);
+        if (bad) status = 1;
+        printf("golden: %d frames, %s\n", num_frames, bad ? "MISMATCH" : "identical");
+    }
+    if (!check_path && !write_path && !bench)
+    {
+        for (int i = 0; i < num_frames; i++)
+        {
+            printf("%s %016llx\n", frames[i].name, (unsigned long long)frames[i].hash);
+        }
+    }
+
+    if (bench)
+    {
+        FILE *out = stdout;
+        if (out_path && !(out = fopen(out_path, "w")))
+        {
+            perror(out_path);
+            return 1;
+        }
+        run_bench(out, n);
+        if (out != stdout) fclose(out);
+    }
+#ifdef PROFILER
+    if (profile_out) fclose(profile_out);
+#endif
+    return status;
+}
@@ -0,0 +1,258 @@
+// Replays recorded games (replay.h) at full speed through the game core and
+// checks that each ends with its recorded score, so a session from the
+// calculator can be reproduced and profiled on the host. --repeat plays the
+// whole file N times for steadier timings. --game G --seek T prints the board
+// of game G after T turns, reached from its keyframes; --check-seek compares
+// that state with a full playback for every turn of every game
+//
+//   blockblast-replay FILE [--repeat N] [--list] [--out FILE]
+//                     [--game G --seek T] [--check-seek]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "replay.h"
+#include "grid.h"
+#include "latency_hist.h"
+
+#ifndef BENCH_GIT_REV
+#define BENCH_GIT_REV "unknown"
+#endif
+
+static replay_t *load(const char *path, int *count, long *bytes)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+    {
+        perror(path);
+        return NULL;
+    }
+
+    int cap = 16;
+    replay_t *games = malloc(cap * sizeof(*games));
+    *count = 0;
+    int status;
+    while (games && (status = replay_read(fp, &games[*count])) == 1)
+    {
+        if (++*count == cap)
+        {
+            cap *= 2;
+            replay_t *grown = realloc(games, cap * sizeof(*games));
+            if (!grown) free(games);
+            games = grown;
+        }
+    }
+    *bytes = ftell(fp);
+    fclose(fp);
+
+    if (!games)
+    {
+        fprintf(stderr, "%s: out of memory\n", path);
+        return NULL;
+    }
+    if (status < 0)
+    {
+        fprintf(stderr, "%s: bad record after %d games\n", path, *count);
+        free(games);
+        return NULL;
+    }
+    return games;
+}
+
+// Game state compared between seeks and playback, as a keyframe holds it
+static void snapshot(replay_keyframe_t *keyframe, const game_ctx_t *ctx)
+{
+    memset(keyframe, 0, sizeof(*keyframe));
+    replay_keyframe_take(keyframe, ctx);
+    // Particles draw from this stream on the add-in only
+    memset(&keyframe->rng[RNG_STREAM_EFFECTS], 0, sizeof(keyframe->rng[0]));
+}
+
+static void print_board(int game, int turn, const game_ctx_t *ctx)
+{
+    printf("game %d, turn %d: score %d%s\n", game, turn, ctx->score.current, ctx->game_over ? ", game over" : "");
+    for (int y = 0; y < GRID_SIZE; y++)
+    {
+        for (int x = 0; x < GRID_SIZE; x++)
+        {
+            if (ctx->grid.occupied >> (y * GRID_SIZE + x) & 1) printf(" %04x", ctx->grid.color[y][x]);
+            else printf("    .");
+        }
+        printf("\n");
+    }
+    printf("pieces:");
+    for (int i = 0; i < 3; i++)
+    {
+        printf(" %s%d", i == ctx->blocks.selected_block ? "*" : "", ctx->blocks.stored_pieces[i]);
+    }
+    printf("\n");
+}
+
+static FILE *open_replays(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp) perror(path);
+    return fp;
+}
+
+// Header of game `game`, leaving fp usable for replay_seek
+static int find_game(FILE *fp, int game, replay_info_t *info)
+{
+    for (int i = 0; i <= game; i++)
+    {
+        if (replay_read_info(fp, info) != 1) return 0;
+    }
+    return 1;
+}
+
+// Every turn of every game: the state replay_seek() reaches against a full
+// playback; returns the number of turns that differ
+static long check_seek(const char *path, const replay_t *games, int count, long *turns)
+{
+    FILE *fp = open_replays(path);
+    if (!fp) return -1;
+
+    static game_ctx_t played, sought;
+    replay_keyframe_t a, b;
+    long bad = 0;
+    *turns = 0;
+    for (int i = 0; i < count; i++)
+    {
+        replay_info_t info;
+        if (replay_read_info(fp, &info) != 1)
+        {
+            bad++;
+            break;
+        }
+        long next = info.end;
+
+        game_ctx_init(&played, games[i].seed);
+        uint32_t pos = 0, turn = 0;
+        int action;
+        do
+        {
+            int reached = replay_seek(fp, &info, turn, &sought);
+            snapshot(&a, &played);
+            snapshot(&b, &sought);
+            if (reached != (int)turn || memcmp(&a, &b, sizeof(a)))
+            {
+                if (bad < 10) printf("game %d: seek to turn %u differs (reached %d)\n", i, (unsigned)turn, reached);
+                bad++;
+            }
+            (*turns)++;
+
+            // Play on to the end of the next turn
+            while ((action = replay_next_action(&games[i], &pos)) >= 0)
+            {
+                if (replay_apply_ctx(&played, (input_action_t)action)) break;
+            }
+            turn++;
+        }
+        while (action >= 0);
+        fseek(fp, next, SEEK_SET);
+    }
+    fclose(fp);
+    return bad;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL, *out_path = NULL;
+    long repeat = 1;
+    int list = 0, game = 0, seek = -1, check = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        int has_value = i + 1 < argc;
+        if (!strcmp(arg, "--repeat") && has_value) repeat = atol(argv[++i]);
+        else if (!strcmp(arg, "--out") && has_value) out_path = argv[++i];
+        else if (!strcmp(arg, "--list")) list = 1;
+        else if (!strcmp(arg, "--game") && has_value) game = atoi(argv[++i]);
+        else if (!strcmp(arg, "--seek") && has_value) seek = atoi(argv[++i]);
+        else if (!strcmp(arg, "--check-seek")) check = 1;
+        else if (arg[0] != '-' && !path) path = arg;
+        else
+        {
+            path = NULL;
+            break;
+        }
+    }
+    if (!path)
+    {
+        fprintf(stderr, "usage: %s FILE [--repeat N] [--list] [--out FILE] [--game G --seek T] [--check-seek]\n",
+                argv[0]);
+        return 2;
+    }
+    if (repeat <= 0) repeat = 1;
+
+    if (seek >= 0)
+    {
+        FILE *fp = open_replays(path);
+        if (!fp) return 1;
+        replay_info_t info;
+        static game_ctx_t ctx;
+        int reached = -1;
+        if (find_game(fp, game, &info)) reached = replay_seek(fp, &info, (uint32_t)seek, &ctx);
+        fclose(fp);
+        if (reached < 0)
+        {
+            fprintf(stderr, "%s: no game %d\n", path, game);
+            return 1;
+        }
+        print_board(game, reached, &ctx);
+        return 0;
+    }
+
+    int count;
+    long bytes;
+    replay_t *games = load(path, &count, &bytes);
+    if (!games) return 1;
+
+    static game_ctx_t ctx;
+    int mismatches = 0;
+    uint64_t actions = 0;
+    uint64_t start = latency_now_ns();
+    for (long r = 0; r < repeat; r++)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            uint32_t score = replay_play_ctx(&ctx, &games[i]);
+            actions += games[i].num_actions;
+            if (r > 0) continue;
+
+            int ok = score == games[i].score;
+            if (!ok) mismatches++;
+            if (list || !ok)
+            {
+                printf("game %d: seed %u, %u actions, %u bytes, score %u (recorded %u)%s\n", i,
+                       (unsigned)games[i].seed, (unsigned)games[i].num_actions, (unsigned)games[i].length,
+                       (unsigned)score, (unsigned)games[i].score, ok ? "" : " MISMATCH");
+            }
+        }
+    }
+    uint64_t ns = latency_now_ns() - start;
+
+    long seek_turns = 0, seek_bad = 0;
+    if (check) seek_bad = check_seek(path, games, count, &seek_turns);
+
+    FILE *out = stdout;
+    if (out_path && !(out = fopen(out_path, "w")))
+    {
+        perror(out_path);
+        free(games);
+        return 1;
+    }
+    fprintf(out, "{\n");
+    fprintf(out, "  \"benchmark\": \"replay\",\n");
+    fprintf(out, "  \"git_rev\": \"%s\",\n", BENCH_GIT_REV);
+    fprintf(out, "  \"games\": %d, \"mismatches\": %d,\n", count, mismatches);
+    fprintf(out, "  \"file_bytes\": %ld, \"bytes_per_game\": %.1f,\n", bytes, count ? (double)bytes / count : 0.0);
+    fprintf(out, "  \"repeat\": %ld, \"actions\": %llu, \"actions_per_sec\": %.0f%s\n", repeat,
+            (unsigned long long)actions, ns ? (double)actions * 1e9 / (double)ns : 0.0, check ? "," : "");
+    if (check) fprintf(out, "  \"seek_turns\": %ld, \"seek_mismatches\": %ld\n", seek_turns, seek_bad);
+    fprintf(out, "}\n");
+    if (out != stdout) fclose(out);
+
+    free(games);
+    return mismatches || seek_bad ? 1 : 0;
+}
@@ -0,0 +1,142 @@
+#include <stddef.h>
+#include "selfplay.h"
+#include "game_state.h"
+#include "grid.h"
+#include "tetris_blocks.h"
+#include "piece_catalog.h"
+
+// Hard stop for a policy that never reaches game over
+#define SELFPLAY_MAX_PLACEMENTS 100000
+
+void selfplay_rng_seed(selfplay_rng_t *rng, uint64_t seed)
+{
+    rng->state = seed;
+}
+
+uint64_t selfplay_rng_next(selfplay_rng_t *rng)
+{
+    uint64_t z = (rng->state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+void selfplay_timing_init(selfplay_timing_t *timing)
+{
+    latency_hist_init(&timing->place);
+    latency_hist_init(&timing->spawn);
+    latency_hist_init(&timing->game_over);
+}
+
+void selfplay_timing_merge(selfplay_timing_t *dst, const selfplay_timing_t *src)
+{
+    latency_hist_merge(&dst->place, &src->place);
+    latency_hist_merge(&dst->spawn, &src->spawn);
+    latency_hist_merge(&dst->game_over, &src->game_over);
+}
+
+void selfplay_game_rng(uint64_t base_seed, uint64_t index, rng_t *root)
+{
+    // Two consecutive splitmix64 outputs are never both zero
+    selfplay_rng_t rng;
+    selfplay_rng_seed(&rng, base_seed ^ (index * 0xD1B54A32D192ED03ull));
+    for (int i = 0; i < 4; i += 2)
+    {
+        uint64_t x = selfplay_rng_next(&rng);
+        root->s[i] = (uint32_t)x;
+        root->s[i + 1] = (uint32_t)(x >> 32);
+    }
+}
+
+uint64_t selfplay_policy_seed(uint64_t base_seed, uint64_t index)
+{
+    selfplay_rng_t rng;
+    selfplay_rng_seed(&rng, ~base_seed ^ (index * 0xD1B54A32D192ED03ull));
+    return selfplay_rng_next(&rng);
+}
+
+int selfplay_choose_move(const game_ctx_t *ctx, selfplay_rng_t *rng, int *slot, int *grid_x, int *grid_y)
+{
+    // Count the free anchors of every sidebar piece, then pick one uniformly
+    uint64_t occupied = grid_get_occupancy_ctx(ctx);
+    uint64_t anchors[3];
+    int total = 0;
+    for (int s = 0; s < 3; s++)
+    {
+        anchors[s] = piece_catalog_free_anchors(tetris_blocks_get_piece_type_for_selection_ctx(ctx, s), occupied);
+        total += __builtin_popcountll(anchors[s]);
+    }
+    if (total == 0) return 0;
+
+    int pick = (int)(selfplay_rng_next(rng) % (uint64_t)total);
+    for (int s = 0; s < 3; s++)
+    {
+        int count = __builtin_popcountll(anchors[s]);
+        if (pick >= count)
+        {
+            pick -= count;
+            continue;
+        }
+        uint64_t m = anchors[s];
+        for (int i = 0; i < pick; i++) m &= m - 1;
+        int bit = __builtin_ctzll(m);
+
+        // anchors are trimmed-box corners; convert back to the 4x4 box origin
+        const piece_info_t *info = piece_catalog_get(tetris_blocks_get_piece_type_for_selection_ctx(ctx, s));
+        *slot = s;
+        *grid_x = bit % GRID_SIZE - info->box_col;
+        *grid_y = bit / GRID_SIZE - info->box_row;
+        return 1;
+    }
+    return 0;
+}
+
+void selfplay_play_game(uint64_t base_seed, uint64_t index, selfplay_result_t *result,
+                        selfplay_timing_t *timing)
+{
+    game_ctx_t ctx;
+    selfplay_rng_t rng;
+    selfplay_rng_seed(&rng, selfplay_policy_seed(base_seed, index));
+    rng_t root;
+    selfplay_game_rng(base_seed, index, &root);
+
+    result->placements = 0;
+    result->lines = 0;
+
+    // Dealing the first three pieces counts as a spawn
+    uint64_t t0 = timing ? latency_now_ns() : 0;
+    game_ctx_init_from(&ctx, &root);
+    result->spawns = 1;
+    if (timing) latency_hist_add(&timing->spawn, latency_now_ns() - t0);
+
+    while (!game_state_is_over_ctx(&ctx) && result->placements < SELFPLAY_MAX_PLACEMENTS)
+    {
+        int slot, gx, gy;
+        if (!selfplay_choose_move(&ctx, &rng, &slot, &gx, &gy)) break;
+
+        uint64_t t0 = timing ? latency_now_ns() : 0;
+        int lines = game_state_lock_piece_ctx(&ctx, slot, gx, gy);
+        uint64_t t1 = timing ? latency_now_ns() : 0;
+        if (lines < 0) break;
+        result->placements++;
+        result->lines += lines;
+
+        // The sidebar is refilled once its last piece is used
+        int remaining;
+        int pieces[3];
+        tetris_blocks_get_available_pieces_ctx(&ctx, pieces, &remaining);
+        game_state_finish_turn_ctx(&ctx);
+        uint64_t t2 = timing ? latency_now_ns() : 0;
+        game_state_check_game_over_ctx(&ctx);
+        uint64_t t3 = timing ? latency_now_ns() : 0;
+
+        if (remaining == 0) result->spawns++;
+        if (timing)
+        {
+            latency_hist_add(&timing->place, t1 - t0);
+            if (remaining == 0) latency_hist_add(&timing->spawn, t2 - t1);
+            latency_hist_add(&timing->game_over, t3 - t2);
+        }
+    }
+    result->score = grid_get_score_ctx(&ctx);
+}
@@ -0,0 +1,50 @@
+#ifndef SELFPLAY_H
+#define SELFPLAY_H
+
+#include <stdint.h>
+#include "latency_hist.h"
+#include "game_ctx.h"
+
+// Self-play driver for host tools: plays complete games through the real
+// placement, line clear, spawn and game-over code of the core, each on
+// its own game context
+
+// splitmix64 stream used by the move policy and to derive game seeds
+typedef struct {
+    uint64_t state;
+} selfplay_rng_t;
+
+void selfplay_rng_seed(selfplay_rng_t *rng, uint64_t seed);
+uint64_t selfplay_rng_next(selfplay_rng_t *rng);
+
+// Outcome of one game
+typedef struct {
+    int placements;
+    int spawns;
+    int lines;
+    int score;
+} selfplay_result_t;
+
+// Optional per-operation latency histograms, in nanoseconds
+typedef struct {
+    latency_hist_t place;     // lock + line clear
+    latency_hist_t spawn;     // sidebar refill (tetris_generate_valid_pieces)
+    latency_hist_t game_over; // game-over check
+} selfplay_timing_t;
+
+void selfplay_timing_init(selfplay_timing_t *timing);
+void selfplay_timing_merge(selfplay_timing_t *dst, const selfplay_timing_t *src);
+
+// Generator state and policy seed of game `index` of a batch started from
+// base_seed; independent of the order games are played in. Game states are
+// 128 bits, so batches of millions of games do not repeat one
+void selfplay_game_rng(uint64_t base_seed, uint64_t index, rng_t *root);
+uint64_t selfplay_policy_seed(uint64_t base_seed, uint64_t index);
+
+// Choose a uniformly random legal (slot, x, y) move; returns 0 if none
+int selfplay_choose_move(const game_ctx_t *ctx, selfplay_rng_t *rng, int *slot, int *grid_x, int *grid_y);
+// Play game `index` of the batch to game over. timing may be NULL
+void selfplay_play_game(uint64_t base_seed, uint64_t index, selfplay_result_t *result,
+                        selfplay_timing_t *timing);
+
+#endif // SELFPLAY_H
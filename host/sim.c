@@ -0,0 +1,247 @@
+// Multi-threaded self-play runner: spreads a seeded batch of games over
+// worker threads with work stealing and prints throughput as JSON. Every
+// game's outcome depends only on (seed, index), so totals and the checksum
+// are the same for any thread count
+//
+//   blockblast-sim [--games N] [--seed S] [--threads T] [--chunk C] [--scaling] [--out FILE]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "piece_catalog.h"
+#include "selfplay.h"
+#include "work_steal.h"
+
+#ifndef BENCH_GIT_REV
+#define BENCH_GIT_REV "unknown"
+#endif
+
+#define SIM_MAX_THREADS 256
+
+typedef struct {
+    long games;
+    uint64_t seed;
+    int threads;
+    uint64_t chunk;
+    int scaling;
+    const char *out_path;
+} sim_options_t;
+
+typedef struct {
+    long games;
+    long placements;
+    long lines;
+    long score;
+    uint64_t checksum; // order-independent digest of every game's outcome
+} sim_totals_t;
+
+typedef struct {
+    work_steal_t *ws;
+    int id;
+    uint64_t seed;
+    sim_totals_t totals;
+} sim_worker_t;
+
+typedef struct {
+    int threads;
+    sim_totals_t totals;
+    long games_per_thread[SIM_MAX_THREADS];
+    uint64_t steals;
+    uint64_t elapsed_ns;
+} sim_run_t;
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s [--games N] [--seed S] [--threads T] [--chunk C] [--scaling] [--out FILE]\n",
+            argv0);
+}
+
+static int parse_options(int argc, char **argv, sim_options_t *opt)
+{
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    opt->games = 10000;
+    opt->seed = 1;
+    opt->threads = online > 0 ? (int)online : 1;
+    opt->chunk = 64;
+    opt->scaling = 0;
+    opt->out_path = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!strcmp(arg, "--games") && value) opt->games = atol(argv[++i]);
+        else if (!strcmp(arg, "--seed") && value) opt->seed = strtoull(argv[++i], NULL, 0);
+        else if (!strcmp(arg, "--threads") && value) opt->threads = atoi(argv[++i]);
+        else if (!strcmp(arg, "--chunk") && value) opt->chunk = strtoull(argv[++i], NULL, 0);
+        else if (!strcmp(arg, "--scaling")) opt->scaling = 1;
+        else if (!strcmp(arg, "--out") && value) opt->out_path = argv[++i];
+        else return 0;
+    }
+    if (opt->threads > SIM_MAX_THREADS) opt->threads = SIM_MAX_THREADS;
+    return opt->games > 0 && opt->threads > 0 && opt->chunk > 0;
+}
+
+static void totals_add_game(sim_totals_t *totals, const selfplay_result_t *result)
+{
+    totals->games++;
+    totals->placements += result->placements;
+    totals->lines += result->lines;
+    totals->score += result->score;
+    totals->checksum += (uint64_t)result->score * 0x9E3779B97F4A7C15ull ^ (uint64_t)result->placements;
+}
+
+static void totals_merge(sim_totals_t *dst, const sim_totals_t *src)
+{
+    dst->games += src->games;
+    dst->placements += src->placements;
+    dst->lines += src->lines;
+    dst->score += src->score;
+    dst->checksum += src->checksum;
+}
+
+static void *worker_main(void *arg)
+{
+    sim_worker_t *worker = arg;
+    uint64_t first, last;
+    while (work_steal_take(worker->ws, worker->id, &first, &last))
+    {
+        for (uint64_t index = first; index < last; index++)
+        {
+            selfplay_result_t result;
+            selfplay_play_game(worker->seed, index, &result, NULL);
+            totals_add_game(&worker->totals, &result);
+        }
+    }
+    return NULL;
+}
+
+static int run_batch(const sim_options_t *opt, int threads, sim_run_t *run)
+{
+    memset(run, 0, sizeof(*run));
+    run->threads = threads;
+
+    work_steal_t ws;
+    if (!work_steal_init(&ws, threads, (uint64_t)opt->games, opt->chunk)) return 0;
+
+    sim_worker_t workers[SIM_MAX_THREADS];
+    pthread_t handles[SIM_MAX_THREADS];
+    memset(workers, 0, sizeof(workers[0]) * (size_t)threads);
+
+    uint64_t start = latency_now_ns();
+    int started = 0;
+    for (; started < threads; started++)
+    {
+        workers[started].ws = &ws;
+        workers[started].id = started;
+        workers[started].seed = opt->seed;
+        if (pthread_create(&handles[started], NULL, worker_main, &workers[started]) != 0) break;
+    }
+    // If a thread failed to start the others steal its slice
+    if (started == 0) worker_main(&workers[0]);
+    for (int t = 0; t < started; t++) pthread_join(handles[t], NULL);
+    run->elapsed_ns = latency_now_ns() - start;
+
+    for (int t = 0; t < threads; t++)
+    {
+        totals_merge(&run->totals, &workers[t].totals);
+        run->games_per_thread[t] = workers[t].totals.games;
+        run->steals += ws.slices[t].steals;
+    }
+    work_steal_free(&ws);
+    return 1;
+}
+
+static void print_run(FILE *out, const sim_run_t *run, const char *indent)
+{
+    double seconds = (double)run->elapsed_ns / 1e9;
+    fprintf(out, "%s\"threads\": %d,\n", indent, run->threads);
+    fprintf(out, "%s\"games\": %ld,\n", indent, run->totals.games);
+    fprintf(out, "%s\"placements\": %ld,\n", indent, run->totals.placements);
+    fprintf(out, "%s\"lines\": %ld,\n", indent, run->totals.lines);
+    fprintf(out, "%s\"checksum\": \"%016llx\",\n", indent, (unsigned long long)run->totals.checksum);
+    fprintf(out, "%s\"elapsed_s\": %.6f,\n", indent, seconds);
+    fprintf(out, "%s\"games_per_s\": %.1f,\n", indent, (double)run->totals.games / seconds);
+    fprintf(out, "%s\"placements_per_s\": %.1f,\n", indent, (double)run->totals.placements / seconds);
+    fprintf(out, "%s\"steals\": %llu,\n", indent, (unsigned long long)run->steals);
+    fprintf(out, "%s\"games_per_thread\": [", indent);
+    for (int t = 0; t < run->threads; t++)
+    {
+        fprintf(out, "%s%ld", t ? ", " : "", run->games_per_thread[t]);
+    }
+    fprintf(out, "]");
+}
+
+int main(int argc, char **argv)
+{
+    sim_options_t opt;
+    if (!parse_options(argc, argv, &opt))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // The catalog is shared read-only by every thread; build it up front
+    piece_catalog_init();
+
+    FILE *out = stdout;
+    if (opt.out_path && !(out = fopen(opt.out_path, "w")))
+    {
+        perror(opt.out_path);
+        return 1;
+    }
+
+    static sim_run_t runs[16];
+    int num_runs = 0;
+    if (opt.scaling)
+    {
+        for (int threads = 1; num_runs < 16; threads *= 2)
+        {
+            if (threads > opt.threads) threads = opt.threads;
+            if (!run_batch(&opt, threads, &runs[num_runs++])) return 1;
+            if (threads == opt.threads) break;
+        }
+    }
+    else if (!run_batch(&opt, opt.threads, &runs[num_runs++]))
+    {
+        return 1;
+    }
+
+    // Totals must not depend on how games were spread over threads
+    int consistent = 1;
+    for (int r = 1; r < num_runs; r++)
+    {
+        if (runs[r].totals.checksum != runs[0].totals.checksum) consistent = 0;
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"benchmark\": \"selfplay_mt\",\n");
+    fprintf(out, "  \"git_rev\": \"%s\",\n", BENCH_GIT_REV);
+    fprintf(out, "  \"seed\": %llu,\n", (unsigned long long)opt.seed);
+    fprintf(out, "  \"chunk\": %llu,\n", (unsigned long long)opt.chunk);
+    if (!opt.scaling)
+    {
+        print_run(out, &runs[0], "  ");
+        fprintf(out, "\n}\n");
+    }
+    else
+    {
+        double base_seconds = (double)runs[0].elapsed_ns / 1e9;
+        fprintf(out, "  \"consistent\": %s,\n", consistent ? "true" : "false");
+        fprintf(out, "  \"scaling\": [\n");
+        for (int r = 0; r < num_runs; r++)
+        {
+            double speedup = base_seconds / ((double)runs[r].elapsed_ns / 1e9);
+            fprintf(out, "    {\n");
+            print_run(out, &runs[r], "      ");
+            fprintf(out, ",\n      \"speedup\": %.2f,\n      \"efficiency\": %.2f\n    }%s\n",
+                    speedup, speedup / runs[r].threads, r + 1 < num_runs ? "," : "");
+        }
+        fprintf(out, "  ]\n}\n");
+    }
+    if (out != stdout) fclose(out);
+
+    return consistent ? 0 : 1;
+}
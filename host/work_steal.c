@@ -0,0 +1,99 @@
+#include <stdlib.h>
+#include "work_steal.h"
+
+int work_steal_init(work_steal_t *ws, int num_workers, uint64_t num_jobs, uint64_t chunk)
+{
+    ws->slices = calloc((size_t)num_workers, sizeof(work_slice_t));
+    if (!ws->slices) return 0;
+    ws->num_workers = num_workers;
+    ws->chunk = chunk ? chunk : 1;
+
+    for (int w = 0; w < num_workers; w++)
+    {
+        work_slice_t *slice = &ws->slices[w];
+        pthread_mutex_init(&slice->lock, NULL);
+        slice->next = num_jobs * (uint64_t)w / (uint64_t)num_workers;
+        slice->end = num_jobs * (uint64_t)(w + 1) / (uint64_t)num_workers;
+    }
+    return 1;
+}
+
+void work_steal_free(work_steal_t *ws)
+{
+    for (int w = 0; w < ws->num_workers; w++)
+    {
+        pthread_mutex_destroy(&ws->slices[w].lock);
+    }
+    free(ws->slices);
+    ws->slices = NULL;
+}
+
+// take up to one chunk from the front of a slice
+static int take_front(work_steal_t *ws, work_slice_t *slice, uint64_t *first, uint64_t *last)
+{
+    int found = 0;
+    pthread_mutex_lock(&slice->lock);
+    if (slice->next < slice->end)
+    {
+        *first = slice->next;
+        *last = slice->end - slice->next > ws->chunk ? slice->next + ws->chunk : slice->end;
+        slice->next = *last;
+        found = 1;
+    }
+    pthread_mutex_unlock(&slice->lock);
+    return found;
+}
+
+// jobs left in a slice, read under its lock
+static uint64_t slice_left(work_slice_t *slice)
+{
+    pthread_mutex_lock(&slice->lock);
+    uint64_t left = slice->next < slice->end ? slice->end - slice->next : 0;
+    pthread_mutex_unlock(&slice->lock);
+    return left;
+}
+
+int work_steal_take(work_steal_t *ws, int worker, uint64_t *first, uint64_t *last)
+{
+    work_slice_t *own = &ws->slices[worker];
+    while (1)
+    {
+        if (take_front(ws, own, first, last)) return 1;
+
+        // Own slice is empty: find the fullest victim (it may shrink before
+        // the steal, so that is rechecked under its lock)
+        int victim = -1;
+        uint64_t most = 0;
+        for (int w = 0; w < ws->num_workers; w++)
+        {
+            if (w == worker) continue;
+            uint64_t left = slice_left(&ws->slices[w]);
+            if (left > most)
+            {
+                most = left;
+                victim = w;
+            }
+        }
+        if (victim < 0) return 0;
+
+        // Move the back half of the victim's slice into our own
+        work_slice_t *from = &ws->slices[victim];
+        uint64_t stolen_first = 0, stolen_end = 0;
+        pthread_mutex_lock(&from->lock);
+        if (from->next < from->end)
+        {
+            uint64_t left = from->end - from->next;
+            stolen_first = from->end - (left + 1) / 2;
+            stolen_end = from->end;
+            from->end = stolen_first;
+        }
+        pthread_mutex_unlock(&from->lock);
+        if (stolen_first == stolen_end) continue;
+
+        pthread_mutex_lock(&own->lock);
+        own->next = stolen_first;
+        own->end = stolen_end;
+        own->steals++;
+        pthread_mutex_unlock(&own->lock);
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef WORK_STEAL_H
+#define WORK_STEAL_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+// Work-stealing scheduler over a range of job indices [0, num_jobs). Each
+// worker owns a contiguous slice, takes small chunks from its front and,
+// once empty, steals the back half of the fullest other slice
+
+typedef struct {
+    pthread_mutex_t lock;
+    uint64_t next;  // front of the slice, taken by the owner
+    uint64_t end;   // back of the slice, shrunk by thieves
+    uint64_t steals;
+} work_slice_t;
+
+typedef struct {
+    work_slice_t *slices;
+    int num_workers;
+    uint64_t chunk;
+} work_steal_t;
+
+// Split num_jobs evenly across num_workers; returns 0 on allocation failure
+int work_steal_init(work_steal_t *ws, int num_workers, uint64_t num_jobs, uint64_t chunk);
+void work_steal_free(work_steal_t *ws);
+// Next chunk [*first, *last) for worker; returns 0 once every slice is empty
+int work_steal_take(work_steal_t *ws, int worker, uint64_t *first, uint64_t *last);
+
+#endif // WORK_STEAL_H
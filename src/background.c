@@ -0,0 +1,40 @@
+#include <gint/display.h>
+#include "background.h"
+#include "grid.h"
+#include "span.h"
+
+// Extent of the lattice, right and bottom lines included
+#define LATTICE_SIZE (GRID_SIZE * GRID_CELL_SIZE + 1)
+
+// Grid lines that fall inside [x0, x1) x [y0, y1)
+static void draw_lattice(int x0, int y0, int x1, int y1)
+{
+    // Lattice rows and columns covered by the clip box
+    int top = y0 > GRID_Y_OFFSET ? y0 : GRID_Y_OFFSET;
+    int bottom = y1 < GRID_Y_OFFSET + LATTICE_SIZE ? y1 : GRID_Y_OFFSET + LATTICE_SIZE;
+    int left = x0 > GRID_X_OFFSET ? x0 : GRID_X_OFFSET;
+    int right = x1 < GRID_X_OFFSET + LATTICE_SIZE ? x1 : GRID_X_OFFSET + LATTICE_SIZE;
+    if (top >= bottom || left >= right) return;
+
+    for (int i = 0; i <= GRID_SIZE; i++)
+    {
+        // Vertical line i
+        int x = GRID_X_OFFSET + i * GRID_CELL_SIZE;
+        if (x >= left && x < right) span_rect(x, top, 1, bottom - top, COLOR_GRID_LINE);
+        // Horizontal line i
+        int y = GRID_Y_OFFSET + i * GRID_CELL_SIZE;
+        if (y >= top && y < bottom) span_fill(left, y, right - left, COLOR_GRID_LINE);
+    }
+}
+
+void background_draw(void)
+{
+    dclear(COLOR_BACKGROUND);
+    draw_lattice(0, 0, DWIDTH, DHEIGHT);
+}
+
+void background_restore(int x, int y, int w, int h)
+{
+    span_rect(x, y, w, h, COLOR_BACKGROUND);
+    draw_lattice(x, y, x + w, y + h);
+}
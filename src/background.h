@@ -0,0 +1,13 @@
+#ifndef BACKGROUND_H
+#define BACKGROUND_H
+
+// Static background of the game screen: uniform fill plus the grid lattice.
+// It is generated on the fly from its geometry, so any region can be
+// restored without keeping a copy of the screen
+
+// Paint the whole background (start of a full frame)
+void background_draw(void);
+// Restore the background inside a w x h rectangle at (x, y)
+void background_restore(int x, int y, int w, int h);
+
+#endif // BACKGROUND_H
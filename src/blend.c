@@ -0,0 +1,51 @@
+#include <string.h>
+#include "blend.h"
+
+// Two pixels loaded and stored as one word
+typedef uint32_t __attribute__((may_alias)) pixel_pair_t;
+
+void blend565_span(uint16_t *dst, const uint16_t *src, int n, int t)
+{
+    int w = blend565_weight(t);
+    int i = 0;
+
+    // Align dst to a word so pairs can be loaded and stored as one
+    if (n > 0 && ((uintptr_t)dst & 2))
+    {
+        dst[0] = blend565_w(dst[0], src[0], w);
+        i = 1;
+    }
+    pixel_pair_t *d = (pixel_pair_t *)(dst + i);
+    if (!(((uintptr_t)src ^ (uintptr_t)dst) & 2))
+    {
+        const pixel_pair_t *s = (const pixel_pair_t *)(src + i);
+        for (; i + 1 < n; i += 2, d++, s++) *d = blend565_x2(*d, *s, w);
+    }
+    else
+    {
+        // src is off by one pixel; the SH4 traps on unaligned word loads
+        for (; i + 1 < n; i += 2, d++)
+        {
+            uint32_t b;
+            memcpy(&b, src + i, sizeof(b));
+            *d = blend565_x2(*d, b, w);
+        }
+    }
+    if (i < n) dst[i] = blend565_w(dst[i], src[i], w);
+}
+
+void blend565_span_color(uint16_t *dst, int n, uint16_t color, int t)
+{
+    int w = blend565_weight(t);
+    uint32_t color2 = ((uint32_t)color << 16) | color;
+    int i = 0;
+
+    if (n > 0 && ((uintptr_t)dst & 2))
+    {
+        dst[0] = blend565_w(dst[0], color, w);
+        i = 1;
+    }
+    pixel_pair_t *d = (pixel_pair_t *)(dst + i);
+    for (; i + 1 < n; i += 2, d++) *d = blend565_x2(*d, color2, w);
+    if (i < n) dst[i] = blend565_w(dst[i], color, w);
+}
@@ -0,0 +1,60 @@
+#ifndef BLEND_H
+#define BLEND_H
+
+#include <stdint.h>
+
+// RGB565 blending without divisions (the SH4 has no integer divide)
+
+// Blend a*(255-t)/255 + b*t/255 per channel, t in [0..255]. Exact: the
+// /255 is done as (x + 1 + (x >> 8)) >> 8, which equals x / 255 for every
+// x up to 255 * 63
+static inline uint16_t blend565(uint16_t a, uint16_t b, int t)
+{
+    int ar = (a >> 11) & 0x1F, ag = (a >> 5) & 0x3F, ab = a & 0x1F;
+    int br = (b >> 11) & 0x1F, bg = (b >> 5) & 0x3F, bb = b & 0x1F;
+    int xr = ar * (255 - t) + br * t;
+    int xg = ag * (255 - t) + bg * t;
+    int xb = ab * (255 - t) + bb * t;
+    int rr = (xr + 1 + (xr >> 8)) >> 8;
+    int rg = (xg + 1 + (xg >> 8)) >> 8;
+    int rb = (xb + 1 + (xb >> 8)) >> 8;
+    return (uint16_t)((rr << 11) | (rg << 5) | rb);
+}
+
+// Packed kernels work on two pixels in one 32-bit word with a 5-bit weight
+// w in [0..32]. Alternate channel fields are split into two words so every
+// field has room for the product above it:
+//   even 0x07E0F81F: B0, R0, G1    odd (>> 5) 0x07C0F83F: G0, B1, R1
+#define BLEND565_EVEN_MASK 0x07E0F81Fu
+#define BLEND565_ODD_MASK 0x07C0F83Fu
+
+// Weight for the packed kernels closest to t in [0..255]
+static inline int blend565_weight(int t)
+{
+    return (t + 4) >> 3;
+}
+
+// Blend two packed pixels: a*(32-w)/32 + b*w/32 per channel
+static inline uint32_t blend565_x2(uint32_t a, uint32_t b, int w)
+{
+    uint32_t ae = a & BLEND565_EVEN_MASK, be = b & BLEND565_EVEN_MASK;
+    uint32_t ao = (a >> 5) & BLEND565_ODD_MASK, bo = (b >> 5) & BLEND565_ODD_MASK;
+    uint32_t even = ((ae * (uint32_t)(32 - w) + be * (uint32_t)w) >> 5) & BLEND565_EVEN_MASK;
+    uint32_t odd = (ao * (uint32_t)(32 - w) + bo * (uint32_t)w) & (BLEND565_ODD_MASK << 5);
+    return even | odd;
+}
+
+// One pixel through the packed kernel, for span ends
+static inline uint16_t blend565_w(uint16_t a, uint16_t b, int w)
+{
+    return (uint16_t)blend565_x2(a, b, w);
+}
+
+// Bulk kernels on rows of pixels, t in [0..255] rounded to a 5-bit weight;
+// they run two pixels per word over the 4-byte aligned part of dst
+// dst[i] = blend(dst[i], src[i], t)
+void blend565_span(uint16_t *dst, const uint16_t *src, int n, int t);
+// dst[i] = blend(dst[i], color, t), for tints, fades and overlays
+void blend565_span_color(uint16_t *dst, int n, uint16_t color, int t);
+
+#endif // BLEND_H
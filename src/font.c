@@ -1,11 +1,14 @@
 #include <gint/display.h>
+#include <stddef.h>
+#include <string.h>
 #include "font.h"
+#include "span.h"
 
 // Tetris block colors (RGB565 format for CG-50)
 #define COLOR_TETRIS_WHITE 0xFFFF  // White in RGB565
 
 // Simple 8x8 pixel font for drawing text
-static const int font_8x8[95][8] = {
+static const uint8_t font_8x8[95][8] = {
     // Space (ASCII 32)
     {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
     // ! (ASCII 33)
@@ -136,20 +139,91 @@ static const int font_8x8[95][8] = {
     {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7E, 0x00}
 };
 
+// Pre-rendered text runs, reused while the same string is drawn again
+#define TEXT_RUN_WIDTH (FONT_TEXT_CACHE_CHARS * 8)
+
+typedef struct {
+    uint16_t pixels[8 * TEXT_RUN_WIDTH]; // first, so rows are word aligned
+    uint32_t hash;      // 0 means the slot is free
+    uint32_t last_used;
+    uint16_t bg;
+    uint8_t len;
+    char text[FONT_TEXT_CACHE_CHARS];
+} text_run_t;
+
+// Two pixels stored as one word
+typedef uint32_t __attribute__((may_alias)) pixel_pair_t;
+
+static text_run_t text_runs[FONT_TEXT_CACHE_SLOTS] __attribute__((aligned(4)));
+static uint32_t text_clock = 0;
+
+const uint8_t *font_get_glyph(char c)
+{
+    if (c < 32 || c > 126) return NULL;
+    return font_8x8[c - 32];
+}
+
+// Glyph rows as opaque 8-pixel spans: four word stores per row, each
+// picking two pixels from a (bg, fg) pair table
+static void raster_glyph_opaque(uint16_t *dst, int stride, const uint8_t *glyph, uint16_t fg, uint16_t bg)
+{
+    uint32_t pairs[4];
+    for (int i = 0; i < 4; i++)
+    {
+        // pixel order in memory: left pixel is bit 1 of the index
+        uint16_t two[2] = { (i & 2) ? fg : bg, (i & 1) ? fg : bg };
+        memcpy(&pairs[i], two, sizeof(pairs[i]));
+    }
+    for (int row = 0; row < 8; row++, dst += stride)
+    {
+        int bits = glyph ? glyph[row] : 0;
+        pixel_pair_t *d = (pixel_pair_t *)dst;
+        d[0] = pairs[(bits >> 6) & 3];
+        d[1] = pairs[(bits >> 4) & 3];
+        d[2] = pairs[(bits >> 2) & 3];
+        d[3] = pairs[bits & 3];
+    }
+}
+
 void font_draw_char(int x, int y, char c)
 {
-    if (c < 32 || c > 126) return; // Invalid character
-    
-    int char_index = c - 32;
+    const uint8_t *glyph = font_get_glyph(c);
+    if (!glyph) return; // Invalid character
+
+    if (x >= 0 && y >= 0 && x + 8 <= DWIDTH && y + 8 <= DHEIGHT)
+    {
+        // Fully visible: masked stores straight into the VRAM rows
+        uint16_t *d = gint_vram + y * DWIDTH + x;
+        for (int row = 0; row < 8; row++, d += DWIDTH)
+        {
+            int bits = glyph[row];
+            if (!bits) continue;
+            if (bits & 0x80) d[0] = COLOR_TETRIS_WHITE;
+            if (bits & 0x40) d[1] = COLOR_TETRIS_WHITE;
+            if (bits & 0x20) d[2] = COLOR_TETRIS_WHITE;
+            if (bits & 0x10) d[3] = COLOR_TETRIS_WHITE;
+            if (bits & 0x08) d[4] = COLOR_TETRIS_WHITE;
+            if (bits & 0x04) d[5] = COLOR_TETRIS_WHITE;
+            if (bits & 0x02) d[6] = COLOR_TETRIS_WHITE;
+            if (bits & 0x01) d[7] = COLOR_TETRIS_WHITE;
+        }
+        return;
+    }
+
+    // Clipped: each run of set bits as one span
     for (int row = 0; row < 8; row++)
     {
-        int pixel_row = font_8x8[char_index][row];
-        for (int col = 0; col < 8; col++)
+        int pixel_row = glyph[row];
+        for (int col = 0; col < 8; )
         {
-            if (pixel_row & (0x80 >> col))
+            if (!(pixel_row & (0x80 >> col)))
             {
-                dpixel(x + col, y + row, COLOR_TETRIS_WHITE);
+                col++;
+                continue;
             }
+            int start = col;
+            while (col < 8 && (pixel_row & (0x80 >> col))) col++;
+            span_fill(x + start, y + row, col - start, COLOR_TETRIS_WHITE);
         }
     }
 }
@@ -171,3 +245,52 @@ void font_draw_text(int x, int y, const char* text)
         text++;
     }
 }
+
+// FNV-1a of the string and background, never 0
+static uint32_t text_hash(const char *text, int len, uint16_t bg)
+{
+    uint32_t h = 2166136261u ^ bg;
+    for (int i = 0; i < len; i++) h = (h ^ (uint8_t)text[i]) * 16777619u;
+    return h ? h : 1;
+}
+
+void font_draw_text_cached(int x, int y, const char *text, uint16_t bg)
+{
+    int len = (int)strlen(text);
+    if (len > FONT_TEXT_CACHE_CHARS)
+    {
+        // Too long for a run: opaque text by hand
+        span_rect(x, y, len * 8, 8, bg);
+        font_draw_text(x, y, text);
+        return;
+    }
+
+    uint32_t hash = text_hash(text, len, bg);
+    int victim = 0;
+    text_clock++;
+    for (int i = 0; i < FONT_TEXT_CACHE_SLOTS; i++)
+    {
+        text_run_t *run = &text_runs[i];
+        if (run->hash == hash && run->len == len && run->bg == bg && !memcmp(run->text, text, len))
+        {
+            run->last_used = text_clock;
+            span_blit(x, y, len * 8, 8, run->pixels, TEXT_RUN_WIDTH);
+            return;
+        }
+        // free slots have last_used 0 and are taken first
+        if (run->last_used < text_runs[victim].last_used) victim = i;
+    }
+
+    // Miss: render the string into the least recently used run
+    text_run_t *run = &text_runs[victim];
+    run->hash = hash;
+    run->last_used = text_clock;
+    run->bg = bg;
+    run->len = (uint8_t)len;
+    memcpy(run->text, text, len);
+    for (int i = 0; i < len; i++)
+    {
+        raster_glyph_opaque(run->pixels + i * 8, TEXT_RUN_WIDTH, font_get_glyph(text[i]), COLOR_TETRIS_WHITE, bg);
+    }
+    span_blit(x, y, len * 8, 8, run->pixels, TEXT_RUN_WIDTH);
+}
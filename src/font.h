@@ -1,8 +1,19 @@
 #ifndef FONT_H
 #define FONT_H
 
+#include <stdint.h>
+
 // Font rendering
 void font_draw_char(int x, int y, char c);
 void font_draw_text(int x, int y, const char* text);
+// 8 bitmap rows of a glyph, MSB = leftmost pixel; NULL if c is not printable
+const uint8_t *font_get_glyph(char c);
+
+// Strings that rarely change (labels, footer) are kept pre-rendered,
+// keyed by content, so redrawing them is a row copy
+#define FONT_TEXT_CACHE_SLOTS 8
+#define FONT_TEXT_CACHE_CHARS 16
+// Draw white text on an opaque bg box (8 pixels per character)
+void font_draw_text_cached(int x, int y, const char *text, uint16_t bg);
 
 #endif // FONT_H
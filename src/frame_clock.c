@@ -0,0 +1,34 @@
+#include <gint/timer.h>
+#include "frame_clock.h"
+
+static volatile uint32_t ticks = 0;
+static volatile int wakeup = 0;
+static int timer_id = -1;
+
+static int frame_clock_tick(void)
+{
+    ticks++;
+    wakeup = 1;
+    return TIMER_CONTINUE;
+}
+
+void frame_clock_start(uint32_t period_us)
+{
+    if (timer_id >= 0) timer_stop(timer_id);
+
+    ticks = 0;
+    wakeup = 0;
+    timer_id = timer_configure(TIMER_ANY, period_us, GINT_CALL(frame_clock_tick));
+    if (timer_id >= 0) timer_start(timer_id);
+}
+
+uint32_t frame_clock_now(void)
+{
+    return ticks;
+}
+
+volatile int *frame_clock_wakeup(void)
+{
+    wakeup = 0;
+    return &wakeup;
+}
@@ -0,0 +1,22 @@
+#ifndef FRAME_CLOCK_H
+#define FRAME_CLOCK_H
+
+#include <stdint.h>
+
+// Tick source of the frame scheduler: a gint timer on the add-in
+// (frame_clock.c), a virtual clock advanced by hand on the host
+// (host/frame_clock_host.c)
+
+// Start ticking every period_us microseconds
+void frame_clock_start(uint32_t period_us);
+// Ticks since frame_clock_start()
+uint32_t frame_clock_now(void);
+// Flag set by the next tick, cleared on return; pass it as the timeout of
+// waitevent() to wait for a key event or the next frame, whichever comes
+// first
+volatile int *frame_clock_wakeup(void);
+
+// Host only: advance the virtual clock by n ticks
+void frame_clock_advance(uint32_t n);
+
+#endif // FRAME_CLOCK_H
@@ -0,0 +1,88 @@
+#include <stddef.h>
+#include <string.h>
+#include "frame_sched.h"
+#include "frame_clock.h"
+
+typedef struct {
+    frame_task_fn fn;
+    void *data;
+    int fresh;  // added during the current update; runs from the next one
+} frame_task_t;
+
+static frame_task_t tasks[FRAME_SCHED_MAX_TASKS];
+static uint32_t last_tick = 0;
+static frame_sched_stats_t stats;
+
+void frame_sched_init(void)
+{
+    memset(tasks, 0, sizeof(tasks));
+    memset(&stats, 0, sizeof(stats));
+    frame_clock_start(FRAME_SCHED_PERIOD_US);
+    last_tick = frame_clock_now();
+}
+
+int frame_sched_add(frame_task_fn fn, void *data)
+{
+    for (int i = 0; i < FRAME_SCHED_MAX_TASKS; i++)
+    {
+        if (tasks[i].fn) continue;
+        // Tasks start on the next tick, not on ticks that already passed
+        if (!frame_sched_busy()) last_tick = frame_clock_now();
+        tasks[i].fn = fn;
+        tasks[i].data = data;
+        tasks[i].fresh = 1;
+        stats.tasks++;
+        return i;
+    }
+    return -1;
+}
+
+void frame_sched_cancel(int id)
+{
+    if (id < 0 || id >= FRAME_SCHED_MAX_TASKS || !tasks[id].fn) return;
+    tasks[id].fn = NULL;
+    stats.tasks--;
+}
+
+int frame_sched_busy(void)
+{
+    return stats.tasks > 0;
+}
+
+int frame_sched_update(void)
+{
+    uint32_t now = frame_clock_now();
+    uint32_t elapsed = now - last_tick;
+    if (elapsed == 0) return 0;
+    last_tick = now;
+
+    // Idle time is not lateness: with no task the loop sleeps in waitevent()
+    if (!frame_sched_busy()) return 0;
+
+    // Every tick beyond the first passed without a frame
+    stats.missed += elapsed - 1;
+    if (elapsed > FRAME_SCHED_MAX_CATCHUP)
+    {
+        stats.dropped += elapsed - FRAME_SCHED_MAX_CATCHUP;
+        elapsed = FRAME_SCHED_MAX_CATCHUP;
+    }
+
+    for (int i = 0; i < FRAME_SCHED_MAX_TASKS; i++) tasks[i].fresh = 0;
+
+    for (uint32_t t = 0; t < elapsed && frame_sched_busy(); t++)
+    {
+        for (int i = 0; i < FRAME_SCHED_MAX_TASKS; i++)
+        {
+            if (!tasks[i].fn || tasks[i].fresh) continue;
+            stats.steps++;
+            if (!tasks[i].fn(tasks[i].data)) frame_sched_cancel(i);
+        }
+    }
+    stats.frames++;
+    return (int)elapsed;
+}
+
+void frame_sched_get_stats(frame_sched_stats_t *out)
+{
+    *out = stats;
+}
@@ -0,0 +1,40 @@
+#ifndef FRAME_SCHED_H
+#define FRAME_SCHED_H
+
+#include <stdint.h>
+
+// Fixed-timestep frame scheduler. Animations run as tasks that advance one
+// step per tick of the frame clock (frame_clock.h), so nothing blocks the
+// main loop while they play
+#define FRAME_SCHED_HZ 30
+#define FRAME_SCHED_PERIOD_US (1000000 / FRAME_SCHED_HZ)
+#define FRAME_SCHED_MAX_TASKS 8
+// Ticks a late update catches up on; older ones are dropped
+#define FRAME_SCHED_MAX_CATCHUP 4
+
+// One animation step; return nonzero to keep running, 0 when done
+typedef int (*frame_task_fn)(void *data);
+
+typedef struct {
+    uint32_t frames;  // updates that ran at least one tick
+    uint32_t steps;   // task steps run
+    uint32_t missed;  // frame deadlines passed without an update
+    uint32_t dropped; // ticks skipped past FRAME_SCHED_MAX_CATCHUP
+    int tasks;        // tasks currently running
+} frame_sched_stats_t;
+
+// Start the frame clock and forget all tasks and stats
+void frame_sched_init(void);
+// Add a task, stepped once per tick from the next update on; returns its id,
+// or -1 if all slots are taken
+int frame_sched_add(frame_task_fn fn, void *data);
+// Stop a task without running it again
+void frame_sched_cancel(int id);
+// Whether any task is running
+int frame_sched_busy(void);
+// Step the tasks once for every tick since the last update; returns the
+// number of ticks run (0 if no frame is due)
+int frame_sched_update(void);
+void frame_sched_get_stats(frame_sched_stats_t *out);
+
+#endif // FRAME_SCHED_H
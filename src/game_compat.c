@@ -0,0 +1,297 @@
+#include "game_ctx.h"
+#include "grid.h"
+#include "tetris_blocks.h"
+#include "score.h"
+#include "game_state.h"
+
+// Single-game API: each function forwards to its _ctx counterpart on the
+// one context the add-in plays
+
+static game_ctx_t default_ctx = {
+    .grid = { .active_block_index = -1 },
+    .blocks = { .stored_pieces = {-1, -1, -1} },
+    .score = { .loaded = -1 },
+};
+
+game_ctx_t *game_ctx_default(void)
+{
+    return &default_ctx;
+}
+
+// grid.h
+
+void grid_init(void)
+{
+    grid_init_ctx(&default_ctx);
+}
+
+void grid_place_block(int piece_type, int grid_x, int grid_y, uint16_t color)
+{
+    grid_place_block_ctx(&default_ctx, piece_type, grid_x, grid_y, color);
+}
+
+void grid_move_active_block(int dx, int dy)
+{
+    grid_move_active_block_ctx(&default_ctx, dx, dy);
+}
+
+void grid_set_active_block(int block_index)
+{
+    grid_set_active_block_ctx(&default_ctx, block_index);
+}
+
+int grid_get_active_block(void)
+{
+    return grid_get_active_block_ctx(&default_ctx);
+}
+
+const placed_block_t *grid_get_active_placed_block(void)
+{
+    return grid_get_active_placed_block_ctx(&default_ctx);
+}
+
+int grid_finalize_active_block(void)
+{
+    return grid_finalize_active_block_ctx(&default_ctx);
+}
+
+int grid_active_overlaps_existing(void)
+{
+    return grid_active_overlaps_existing_ctx(&default_ctx);
+}
+
+int grid_would_overlap(int piece_type, int grid_x, int grid_y)
+{
+    return grid_would_overlap_ctx(&default_ctx, piece_type, grid_x, grid_y);
+}
+
+int grid_can_place(int piece_type, int grid_x, int grid_y)
+{
+    return grid_can_place_ctx(&default_ctx, piece_type, grid_x, grid_y);
+}
+
+int grid_find_first_fit(int piece_type, int *out_x, int *out_y)
+{
+    return grid_find_first_fit_ctx(&default_ctx, piece_type, out_x, out_y);
+}
+
+uint64_t grid_get_occupancy(void)
+{
+    return grid_get_occupancy_ctx(&default_ctx);
+}
+
+uint16_t grid_get_cell_color(int x, int y)
+{
+    return grid_get_cell_color_ctx(&default_ctx, x, y);
+}
+
+int grid_cancel_active_block(void)
+{
+    return grid_cancel_active_block_ctx(&default_ctx);
+}
+
+uint16_t grid_get_active_block_color(void)
+{
+    return grid_get_active_block_color_ctx(&default_ctx);
+}
+
+int grid_clear_pending(void)
+{
+    return grid_clear_pending_ctx(&default_ctx);
+}
+
+uint64_t grid_clear_step(void)
+{
+    return grid_clear_step_ctx(&default_ctx);
+}
+
+void grid_clear_finish(void)
+{
+    grid_clear_finish_ctx(&default_ctx);
+}
+
+int grid_get_score(void)
+{
+    return grid_get_score_ctx(&default_ctx);
+}
+
+int grid_would_clear_lines(int piece_type, int grid_x, int grid_y)
+{
+    return grid_would_clear_lines_ctx(&default_ctx, piece_type, grid_x, grid_y);
+}
+
+int grid_lines_cleared_by(int piece_type, int grid_x, int grid_y, uint8_t *full_rows, uint8_t *full_cols)
+{
+    return grid_lines_cleared_by_ctx(&default_ctx, piece_type, grid_x, grid_y, full_rows, full_cols);
+}
+
+// score.h
+
+void score_init(void)
+{
+    score_init_ctx(&default_ctx);
+}
+
+int score_get_current(void)
+{
+    return score_get_current_ctx(&default_ctx);
+}
+
+void score_add_placement(void)
+{
+    score_add_placement_ctx(&default_ctx);
+}
+
+void score_add_points(int points)
+{
+    score_add_points_ctx(&default_ctx, points);
+}
+
+void score_set_loaded(int value)
+{
+    score_set_loaded_ctx(&default_ctx, value);
+}
+
+int score_get_loaded(void)
+{
+    return score_get_loaded_ctx(&default_ctx);
+}
+
+// tetris_blocks.h
+
+void tetris_blocks_init(uint32_t seed)
+{
+    tetris_blocks_init_ctx(&default_ctx, seed);
+}
+
+int tetris_blocks_get_selection(void)
+{
+    return tetris_blocks_get_selection_ctx(&default_ctx);
+}
+
+void tetris_blocks_set_selection(int selection)
+{
+    tetris_blocks_set_selection_ctx(&default_ctx, selection);
+}
+
+int tetris_blocks_get_piece_type_for_selection(int selection)
+{
+    return tetris_blocks_get_piece_type_for_selection_ctx(&default_ctx, selection);
+}
+
+uint16_t tetris_blocks_get_piece_color_for_slot(int slot)
+{
+    return tetris_blocks_get_piece_color_for_slot_ctx(&default_ctx, slot);
+}
+
+uint16_t tetris_blocks_get_color_for_piece_type(int piece_type)
+{
+    return tetris_blocks_get_color_for_piece_type_ctx(&default_ctx, piece_type);
+}
+
+void tetris_blocks_consume_selected(void)
+{
+    tetris_blocks_consume_selected_ctx(&default_ctx);
+}
+
+void tetris_blocks_regenerate_if_needed(void)
+{
+    tetris_blocks_regenerate_if_needed_ctx(&default_ctx);
+}
+
+void tetris_blocks_get_available_pieces(int pieces[], int *count)
+{
+    tetris_blocks_get_available_pieces_ctx(&default_ctx, pieces, count);
+}
+
+void tetris_blocks_restore_piece(int piece_type)
+{
+    tetris_blocks_restore_piece_ctx(&default_ctx, piece_type);
+}
+
+void tetris_blocks_restore_piece_with_color(int piece_type, uint16_t color)
+{
+    tetris_blocks_restore_piece_with_color_ctx(&default_ctx, piece_type, color);
+}
+
+int tetris_piece_is_placeable(int piece_type)
+{
+    return tetris_piece_is_placeable_ctx(&default_ctx, piece_type);
+}
+
+int tetris_generate_weighted_piece(void)
+{
+    return tetris_generate_weighted_piece_ctx(&default_ctx);
+}
+
+void tetris_generate_valid_pieces(void)
+{
+    tetris_generate_valid_pieces_ctx(&default_ctx);
+}
+
+// game_state.h
+
+void game_state_init(void)
+{
+    game_state_init_ctx(&default_ctx);
+}
+
+void game_state_reset(uint32_t seed)
+{
+    game_state_reset_ctx(&default_ctx, seed);
+}
+
+int game_state_is_over(void)
+{
+    return game_state_is_over_ctx(&default_ctx);
+}
+
+void game_state_set_over(int is_over)
+{
+    game_state_set_over_ctx(&default_ctx, is_over);
+}
+
+void game_state_check_game_over(void)
+{
+    game_state_check_game_over_ctx(&default_ctx);
+}
+
+int game_state_pick_selected(void)
+{
+    return game_state_pick_selected_ctx(&default_ctx);
+}
+
+int game_state_place_active(void)
+{
+    return game_state_place_active_ctx(&default_ctx);
+}
+
+void game_state_finish_turn(void)
+{
+    game_state_finish_turn_ctx(&default_ctx);
+}
+
+int game_state_cancel_active(void)
+{
+    return game_state_cancel_active_ctx(&default_ctx);
+}
+
+void game_state_move(int dx, int dy)
+{
+    game_state_move_ctx(&default_ctx, dx, dy);
+}
+
+void game_state_move_path(const int8_t *dx, const int8_t *dy, int n)
+{
+    game_state_move_path_ctx(&default_ctx, dx, dy, n);
+}
+
+int game_state_lock_piece(int slot, int grid_x, int grid_y)
+{
+    return game_state_lock_piece_ctx(&default_ctx, slot, grid_x, grid_y);
+}
+
+int game_state_place_piece(int slot, int grid_x, int grid_y)
+{
+    return game_state_place_piece_ctx(&default_ctx, slot, grid_x, grid_y);
+}
@@ -0,0 +1,16 @@
+#include "game_ctx.h"
+#include "game_state.h"
+
+void game_ctx_init(game_ctx_t *ctx, uint32_t seed)
+{
+    // game_state_reset_ctx sets everything but the loaded score, which
+    // survives resets so the add-in can keep showing it
+    ctx->score.loaded = -1;
+    game_state_reset_ctx(ctx, seed);
+}
+
+void game_ctx_init_from(game_ctx_t *ctx, const rng_t *root)
+{
+    ctx->score.loaded = -1;
+    game_state_reset_from_ctx(ctx, root);
+}
@@ -0,0 +1,61 @@
+#ifndef GAME_CTX_H
+#define GAME_CTX_H
+
+#include <stdint.h>
+#include "rng.h"
+
+// Declared ahead of grid.h, whose prototypes take a game_ctx_t *
+typedef struct game_ctx game_ctx_t;
+
+#include "grid.h"
+
+// Complete state of one game. The grid, tetris_blocks, score and game_state
+// *_ctx functions read and write only the context they are given, so any
+// number of games can live side by side; copying a context snapshots a game.
+// The add-in plays the single context behind game_ctx_default() through the
+// original functions without the _ctx suffix (game_compat.c)
+
+typedef struct {
+    // Hot: read by every placement, fit and game-over check
+    uint64_t occupied;          // locked cells, one bit per cell (see GRID_BIT)
+    uint8_t row_fill[GRID_SIZE]; // locked cells per row, in step with occupied
+    uint8_t col_fill[GRID_SIZE]; // locked cells per column
+    // Line clear in progress: cells of the full lines still being swept
+    uint64_t sweep_lines;
+    int sweep_step;
+    int sweep_count;
+    // Piece being moved around before it is locked
+    int active_block_index;     // -1 means no active block
+    int num_placed_blocks;
+    placed_block_t placed_blocks[MAX_PLACED_BLOCKS];
+    // Cold: only read when drawing
+    uint16_t color[GRID_SIZE][GRID_SIZE];
+} grid_state_t;
+
+typedef struct {
+    int selected_block;
+    int stored_pieces[3];       // -1 means consumed or not generated yet
+    uint16_t stored_piece_colors[3];
+} tetris_blocks_state_t;
+
+typedef struct {
+    int current;
+    int loaded;                 // -1 means not set
+} score_state_t;
+
+struct game_ctx {
+    grid_state_t grid;
+    tetris_blocks_state_t blocks;
+    score_state_t score;
+    int game_over;
+    rng_t rng[RNG_STREAM_COUNT]; // one stream per use of randomness, from the seed
+};
+
+// Prepare a fresh context and start a game with the given seed
+void game_ctx_init(game_ctx_t *ctx, uint32_t seed);
+// The same with the game's streams started from root instead of a seed
+void game_ctx_init_from(game_ctx_t *ctx, const rng_t *root);
+// The context played by the add-in and the functions without _ctx
+game_ctx_t *game_ctx_default(void);
+
+#endif // GAME_CTX_H
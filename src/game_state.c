@@ -1,52 +1,171 @@
-#include <gint/display.h>
 #include "game_state.h"
 #include "grid.h"
 #include "tetris_blocks.h"
+#include "oracle.h"
 
-// Game state
-static int game_over = 0;
-
-void game_state_init(void)
+void game_state_init_ctx(game_ctx_t *ctx)
 {
-    game_over = 0;
+    ctx->game_over = 0;
 }
 
-void game_state_reset(void)
+void game_state_reset_ctx(game_ctx_t *ctx, uint32_t seed)
 {
-    // Clear the display buffer first
-    dclear(COLOR_BACKGROUND);
-    
     // Reset all game states
-    grid_init();
-    tetris_blocks_init();
-    game_over = 0;
-    
-    // Redraw everything
-    grid_draw();
-    grid_draw_placed_blocks();
-    grid_draw_score();
-    tetris_blocks_draw();
-    dupdate();
+    grid_init_ctx(ctx);
+    tetris_blocks_init_ctx(ctx, seed);
+    ctx->game_over = 0;
 }
 
-int game_state_is_over(void)
+void game_state_reset_from_ctx(game_ctx_t *ctx, const rng_t *root)
 {
-    return game_over;
+    grid_init_ctx(ctx);
+    tetris_blocks_init_from_ctx(ctx, root);
+    ctx->game_over = 0;
 }
 
-void game_state_set_over(int is_over)
+int game_state_is_over_ctx(const game_ctx_t *ctx)
 {
-    game_over = is_over;
+    return ctx->game_over;
 }
 
-void game_state_check_game_over(void)
+void game_state_set_over_ctx(game_ctx_t *ctx, int is_over)
+{
+    ctx->game_over = is_over;
+}
+
+void game_state_check_game_over_ctx(game_ctx_t *ctx)
 {
     int available_pieces[3];
     int piece_count;
-    tetris_blocks_get_available_pieces(available_pieces, &piece_count);
+    tetris_blocks_get_available_pieces_ctx(ctx, available_pieces, &piece_count);
     
-    if (piece_count > 0 && !grid_can_any_piece_fit(available_pieces, piece_count))
+    if (piece_count > 0 && !oracle_any_piece_fits(ctx->grid.occupied, available_pieces, piece_count))
     {
-        game_over = 1;
+        ctx->game_over = 1;
     }
 }
+
+int game_state_pick_selected_ctx(game_ctx_t *ctx)
+{
+    int current_selection = tetris_blocks_get_selection_ctx(ctx);
+    int piece_type = tetris_blocks_get_piece_type_for_selection_ctx(ctx, current_selection);
+    if (piece_type < 0)
+    {
+        // No available selection; try to regenerate if all consumed
+        tetris_blocks_regenerate_if_needed_ctx(ctx);
+        // Re-evaluate selection after potential regeneration
+        current_selection = tetris_blocks_get_selection_ctx(ctx);
+        piece_type = tetris_blocks_get_piece_type_for_selection_ctx(ctx, current_selection);
+        if (piece_type < 0) return 0; // Still nothing to place
+    }
+    // Always place at top left corner (0, 0)
+    if (!grid_is_valid_position(piece_type, 0, 0)) return 0;
+
+    // Determine the color assigned to this selected slot
+    uint16_t color = tetris_blocks_get_piece_color_for_slot_ctx(ctx, current_selection);
+    grid_place_block_ctx(ctx, piece_type, 0, 0, color);
+    // Consume the sidebar piece used
+    tetris_blocks_consume_selected_ctx(ctx);
+    return 1;
+}
+
+int game_state_place_active_ctx(game_ctx_t *ctx)
+{
+    if (grid_get_active_block_ctx(ctx) == -1) return -1;
+    // If active block overlaps an existing block, refuse to lock it
+    if (grid_active_overlaps_existing_ctx(ctx)) return -1;
+    return grid_finalize_active_block_ctx(ctx);
+}
+
+void game_state_finish_turn_ctx(game_ctx_t *ctx)
+{
+    grid_clear_finish_ctx(ctx);
+    // Regenerate pieces if needed after placing
+    tetris_blocks_regenerate_if_needed_ctx(ctx);
+}
+
+int game_state_cancel_active_ctx(game_ctx_t *ctx)
+{
+    if (grid_get_active_block_ctx(ctx) == -1) return 0;
+    uint16_t color = grid_get_active_block_color_ctx(ctx);
+    int piece_type = grid_cancel_active_block_ctx(ctx);
+    if (piece_type >= 0)
+    {
+        tetris_blocks_restore_piece_with_color_ctx(ctx, piece_type, color);
+    }
+    return 1;
+}
+
+void game_state_move_ctx(game_ctx_t *ctx, int dx, int dy)
+{
+    if (grid_get_active_block_ctx(ctx) != -1)
+    {
+        grid_move_active_block_ctx(ctx, dx, dy);
+        return;
+    }
+
+    // Otherwise, change block selection
+    int current_selection = tetris_blocks_get_selection_ctx(ctx);
+    if (dy < 0 && current_selection > 0)
+    {
+        tetris_blocks_set_selection_ctx(ctx, current_selection - 1);
+    }
+    else if (dy > 0 && current_selection < 2)  // We have 3 blocks (0, 1, 2)
+    {
+        tetris_blocks_set_selection_ctx(ctx, current_selection + 1);
+    }
+}
+
+void game_state_move_path_ctx(game_ctx_t *ctx, const int8_t *dx, const int8_t *dy, int n)
+{
+    const placed_block_t *active = grid_get_active_placed_block_ctx(ctx);
+    if (active)
+    {
+        // A step the block cannot take is dropped, as game_state_move does
+        int x = active->grid_x, y = active->grid_y;
+        for (int i = 0; i < n; i++)
+        {
+            if (!grid_is_valid_position(active->piece_type, x + dx[i], y + dy[i])) continue;
+            x += dx[i];
+            y += dy[i];
+        }
+        grid_move_active_block_ctx(ctx, x - active->grid_x, y - active->grid_y);
+        return;
+    }
+
+    // Selection: each up/down step moves one slot within the three and then
+    // skips empty slots, as tetris_blocks_set_selection does per move
+    int selection = tetris_blocks_get_selection_ctx(ctx);
+    int start = selection;
+    for (int i = 0; i < n; i++)
+    {
+        if (dy[i] < 0 && selection > 0) selection = tetris_blocks_resolve_selection_ctx(ctx, selection - 1);
+        else if (dy[i] > 0 && selection < 2) selection = tetris_blocks_resolve_selection_ctx(ctx, selection + 1);
+    }
+    if (selection != start) tetris_blocks_set_selection_ctx(ctx, selection);
+}
+
+int game_state_lock_piece_ctx(game_ctx_t *ctx, int slot, int grid_x, int grid_y)
+{
+    if (grid_get_active_block_ctx(ctx) != -1) return -1;
+    int piece_type = tetris_blocks_get_piece_type_for_selection_ctx(ctx, slot);
+    if (piece_type < 0 || !grid_can_place_ctx(ctx, piece_type, grid_x, grid_y)) return -1;
+
+    uint16_t color = tetris_blocks_get_piece_color_for_slot_ctx(ctx, slot);
+    tetris_blocks_set_selection_ctx(ctx, slot);
+    grid_place_block_ctx(ctx, piece_type, grid_x, grid_y, color);
+    tetris_blocks_consume_selected_ctx(ctx);
+
+    int lines_cleared = grid_finalize_active_block_ctx(ctx);
+    grid_clear_finish_ctx(ctx);
+    return lines_cleared;
+}
+
+int game_state_place_piece_ctx(game_ctx_t *ctx, int slot, int grid_x, int grid_y)
+{
+    int lines_cleared = game_state_lock_piece_ctx(ctx, slot, grid_x, grid_y);
+    if (lines_cleared < 0) return -1;
+    game_state_finish_turn_ctx(ctx);
+    game_state_check_game_over_ctx(ctx);
+    return lines_cleared;
+}
@@ -1,11 +1,56 @@
 #ifndef GAME_STATE_H
 #define GAME_STATE_H
 
-// Game state management
+#include <stdint.h>
+#include "game_ctx.h"
+
+// Game state management on an explicit context (game_state.c)
+void game_state_init_ctx(game_ctx_t *ctx);
+// Start a new game; the seed fixes the sequence of dealt pieces
+void game_state_reset_ctx(game_ctx_t *ctx, uint32_t seed);
+// The same from a full generator state (tetris_blocks_init_from_ctx)
+void game_state_reset_from_ctx(game_ctx_t *ctx, const rng_t *root);
+int game_state_is_over_ctx(const game_ctx_t *ctx);
+void game_state_set_over_ctx(game_ctx_t *ctx, int is_over);
+void game_state_check_game_over_ctx(game_ctx_t *ctx);
+
+// Game operations, shared by the add-in input handler and host tools
+// Pick the selected sidebar piece up as the active block at the top-left
+// corner; returns 0 if there is nothing to pick up
+int game_state_pick_selected_ctx(game_ctx_t *ctx);
+// Lock the active block in place; returns the number of lines it completed,
+// or -1 if there is no active block or it overlaps locked cells. The clear
+// sweep is left pending (see grid_clear_step) until game_state_finish_turn
+int game_state_place_active_ctx(game_ctx_t *ctx);
+// Finish any pending clear sweep and refill the sidebar once it is empty
+void game_state_finish_turn_ctx(game_ctx_t *ctx);
+// Put the active block back on the sidebar; returns 0 if there was none
+int game_state_cancel_active_ctx(game_ctx_t *ctx);
+// Move the active block, or the sidebar selection (dy only) if there is none
+void game_state_move_ctx(game_ctx_t *ctx, int dx, int dy);
+// Same end state as game_state_move for each (dx[i], dy[i]) in order, with
+// the steps folded into one net displacement (or sidebar slot) first
+void game_state_move_path_ctx(game_ctx_t *ctx, const int8_t *dx, const int8_t *dy, int n);
+// Lock the piece in sidebar slot at (grid_x, grid_y) and run its clear
+// sweep, without refilling the sidebar. Returns the number of lines
+// cleared, or -1 if the slot is empty or the placement is illegal
+int game_state_lock_piece_ctx(game_ctx_t *ctx, int slot, int grid_x, int grid_y);
+// game_state_lock_piece, then refill the sidebar and re-check game over
+int game_state_place_piece_ctx(game_ctx_t *ctx, int slot, int grid_x, int grid_y);
+
+// The same on game_ctx_default() (game_compat.c)
 void game_state_init(void);
-void game_state_reset(void);
+void game_state_reset(uint32_t seed);
 int game_state_is_over(void);
 void game_state_set_over(int is_over);
 void game_state_check_game_over(void);
+int game_state_pick_selected(void);
+int game_state_place_active(void);
+void game_state_finish_turn(void);
+int game_state_cancel_active(void);
+void game_state_move(int dx, int dy);
+void game_state_move_path(const int8_t *dx, const int8_t *dy, int n);
+int game_state_lock_piece(int slot, int grid_x, int grid_y);
+int game_state_place_piece(int slot, int grid_x, int grid_y);
 
 #endif // GAME_STATE_H
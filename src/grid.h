@@ -1,12 +1,17 @@
 #ifndef GRID_H
 #define GRID_H
 
-#include <gint/display.h>
+#include <stdint.h>
 
 // Grid dimensions - 8x8 centered
 #define GRID_SIZE 8
 #define GRID_CELL_SIZE 20  // 20x20 pixel cells
 
+// Occupancy bitboard layout: cell (x, y) is bit y * GRID_SIZE + x
+#define GRID_BIT(x, y) ((uint64_t)1 << ((y) * GRID_SIZE + (x)))
+#define GRID_ROW_MASK 0x00000000000000FFull  // all cells of row 0
+#define GRID_COL_MASK 0x0101010101010101ull  // all cells of column 0
+
 // Grid colors (RGB565 format for CG-50)
 #define COLOR_BACKGROUND 0x3270  // #364C87 converted to RGB565
 #define COLOR_GRID_LINE 0x1907   // #1A1F3D converted to RGB565
@@ -35,34 +40,90 @@ typedef struct {
     uint16_t color;  // RGB565 color of the piece
 } placed_block_t;
 
-// Function declarations
+#include "game_ctx.h"
+
+// Game logic on an explicit context (grid.c)
+void grid_init_ctx(game_ctx_t *ctx);
+void grid_place_block_ctx(game_ctx_t *ctx, int piece_type, int grid_x, int grid_y, uint16_t color);
+void grid_move_active_block_ctx(game_ctx_t *ctx, int dx, int dy);
+void grid_set_active_block_ctx(game_ctx_t *ctx, int block_index);
+int grid_get_active_block_ctx(const game_ctx_t *ctx);
+// Active placed block, or NULL if none
+const placed_block_t *grid_get_active_placed_block_ctx(const game_ctx_t *ctx);
+// Whether the piece's box fits inside the grid; needs no context
+int grid_is_valid_position(int piece_type, int grid_x, int grid_y);
+// Lock the active block into the grid; returns the number of lines it
+// completed, which stay on the grid until the clear sweep runs
+int grid_finalize_active_block_ctx(game_ctx_t *ctx);
+int grid_active_overlaps_existing_ctx(const game_ctx_t *ctx);
+int grid_would_overlap_ctx(const game_ctx_t *ctx, int piece_type, int grid_x, int grid_y);
+int grid_can_place_ctx(const game_ctx_t *ctx, int piece_type, int grid_x, int grid_y);
+// Find first valid position for a piece; returns 1 if found and sets out_x/out_y
+int grid_find_first_fit_ctx(const game_ctx_t *ctx, int piece_type, int *out_x, int *out_y);
+// Bitboard of locked cells (see GRID_BIT)
+uint64_t grid_get_occupancy_ctx(const game_ctx_t *ctx);
+// RGB565 color of a locked cell
+uint16_t grid_get_cell_color_ctx(const game_ctx_t *ctx, int x, int y);
+// Cancel active block placement and return piece type for restoration
+int grid_cancel_active_block_ctx(game_ctx_t *ctx);
+// Get the color of the currently active block (or default red if none)
+uint16_t grid_get_active_block_color_ctx(const game_ctx_t *ctx);
+// Line clear sweep: full rows clear left->right and full columns top->bottom,
+// one column/row per step over GRID_SIZE steps; points are awarded on the last
+int grid_clear_pending_ctx(const game_ctx_t *ctx);
+// Run one sweep step; returns the bitboard of cells it cleared
+uint64_t grid_clear_step_ctx(game_ctx_t *ctx);
+// Run the rest of the sweep at once
+void grid_clear_finish_ctx(game_ctx_t *ctx);
+// Score management
+int grid_get_score_ctx(const game_ctx_t *ctx);
+// Check if placing a piece at a position would clear any lines
+int grid_would_clear_lines_ctx(const game_ctx_t *ctx, int piece_type, int grid_x, int grid_y);
+// Number of lines a non-overlapping placement would clear; sets bit i of
+// full_rows/full_cols for each row/column i it completes (either may be NULL)
+int grid_lines_cleared_by_ctx(const game_ctx_t *ctx, int piece_type, int grid_x, int grid_y,
+                              uint8_t *full_rows, uint8_t *full_cols);
+
+// The same on game_ctx_default() (game_compat.c)
 void grid_init(void);
-void grid_draw(void);
-void grid_clear(void);
 void grid_place_block(int piece_type, int grid_x, int grid_y, uint16_t color);
 void grid_move_active_block(int dx, int dy);
 void grid_set_active_block(int block_index);
 int grid_get_active_block(void);
-void grid_draw_placed_blocks(void);
-int grid_is_valid_position(int piece_type, int grid_x, int grid_y);
-void grid_finalize_active_block(void);
+const placed_block_t *grid_get_active_placed_block(void);
+int grid_finalize_active_block(void);
 int grid_active_overlaps_existing(void);
 int grid_would_overlap(int piece_type, int grid_x, int grid_y);
 int grid_can_place(int piece_type, int grid_x, int grid_y);
-// Find first valid position for a piece; returns 1 if found and sets out_x/out_y
 int grid_find_first_fit(int piece_type, int *out_x, int *out_y);
-// Check if any piece can be placed anywhere on the grid
-int grid_can_any_piece_fit(int available_pieces[], int num_pieces);
-// Display GAME OVER text in the center of the screen
-void grid_draw_game_over(void);
-// Cancel active block placement and return piece type for restoration
+uint64_t grid_get_occupancy(void);
+uint16_t grid_get_cell_color(int x, int y);
 int grid_cancel_active_block(void);
-// Get the color of the currently active block (or default red if none)
 uint16_t grid_get_active_block_color(void);
-// Score management
+int grid_clear_pending(void);
+uint64_t grid_clear_step(void);
+void grid_clear_finish(void);
 int grid_get_score(void);
-void grid_draw_score(void);
-// Check if placing a piece at a position would clear any lines
 int grid_would_clear_lines(int piece_type, int grid_x, int grid_y);
+int grid_lines_cleared_by(int piece_type, int grid_x, int grid_y, uint8_t *full_rows, uint8_t *full_cols);
+
+// Drawing (grid_draw.c, add-in only)
+void grid_clear(void);
+void grid_draw_placed_blocks(void);
+// Repaint one cell: background, its grid lines, locked tile and active tile
+void grid_draw_cell(int x, int y);
+void grid_draw_score(void);
+// Display GAME OVER text in the center of the screen
+void grid_draw_game_over(void);
+// Play the pending line clear sweep with particles as frame scheduler
+// tasks (frame_sched.h), one sweep step per tick; done() runs once the
+// sweep is over (at once if nothing is pending)
+void grid_start_line_clear(void (*done)(void));
+int grid_line_clear_running(void);
+// Finish a running sweep now, calling its done()
+void grid_skip_line_clear(void);
+// Particles left by the sweep; drawn over the frame while any is alive
+int grid_particles_active(void);
+void grid_draw_particles(void);
 
 #endif // GRID_H
@@ -0,0 +1,205 @@
+#include <gint/display.h>
+#include <stddef.h>
+#include "grid.h"
+#include "tetris_blocks.h"
+#include "score.h"
+#include "renderer.h"
+#include "piece_catalog.h"
+#include "span.h"
+#include "background.h"
+#include "frame_sched.h"
+#include "particles.h"
+
+// color for particles
+#define COLOR_TETRIS_RED 0xF800
+
+// Particles draw from the game's effects stream, so a line clear looks
+// the same every time a seed is replayed
+static int rand_range(int min_inclusive, int max_inclusive)
+{
+	return rng_range(&game_ctx_default()->rng[RNG_STREAM_EFFECTS], min_inclusive, max_inclusive);
+}
+
+static void spawn_cell_explosion(int grid_x, int grid_y)
+{
+	int cell_x = GRID_X_OFFSET + grid_x * GRID_CELL_SIZE;
+	int cell_y = GRID_Y_OFFSET + grid_y * GRID_CELL_SIZE;
+	int cx = cell_x + GRID_CELL_SIZE / 2;
+	int cy = cell_y + GRID_CELL_SIZE / 2;
+
+	// Spawn a handful of particles with sub-pixel velocities; a full pool
+	// just drops the rest
+	for (int i = 0; i < 6; i++)
+	{
+		particles_spawn(cx * PARTICLE_ONE, cy * PARTICLE_ONE,
+			rand_range(-2 * PARTICLE_ONE, 2 * PARTICLE_ONE),
+			rand_range(-3 * PARTICLE_ONE, -PARTICLE_ONE),
+			rand_range(6, 12));
+	}
+}
+
+static int particle_task_id = -1;
+
+// Scheduler task: move the particles one tick; runs while any is alive
+static int particles_task(void *data)
+{
+	(void)data;
+	int alive = particles_step();
+	if (!alive) particle_task_id = -1;
+	return alive;
+}
+
+// draw a single filled cell at grid coords with outline
+static void draw_filled_cell(int grid_x, int grid_y)
+{
+	renderer_draw_filled_cell(grid_x, grid_y);
+}
+
+// tile color of the active block: red tint if it overlaps locked cells,
+// white tint if it is free
+static void set_active_tint(const placed_block_t *active)
+{
+    uint16_t base = active->color;
+    if (grid_active_overlaps_existing())
+    {
+        // red tint if overlapping on other pieces
+        uint16_t dark_red = 0x7800;
+        renderer_set_tile_color(renderer_blend565(base, dark_red, 200));
+    }
+    else
+    {
+        // white tint if free
+        renderer_set_tile_color(renderer_blend565(base, 0xFFFF, 96));
+    }
+}
+
+void grid_clear(void)
+{
+    // Clear the grid area (8x8 centered)
+    drect(GRID_X_OFFSET, GRID_Y_OFFSET, 
+          GRID_SIZE * GRID_CELL_SIZE, 
+          GRID_SIZE * GRID_CELL_SIZE, 
+          COLOR_BACKGROUND);
+}
+
+void grid_draw_placed_blocks(void)
+{
+    // First draw all locked cells from occupancy (non-active color)
+    uint64_t occupied = grid_get_occupancy();
+    for (int y = 0; y < GRID_SIZE; y++)
+    {
+        for (int x = 0; x < GRID_SIZE; x++)
+        {
+            if (occupied & GRID_BIT(x, y))
+            {
+                renderer_set_tile_color(grid_get_cell_color(x, y));
+                draw_filled_cell(x, y);
+            }
+        }
+    }
+
+    // Then draw the active block if any (selected color handled by draw function)
+    const placed_block_t *active = grid_get_active_placed_block();
+    if (active)
+    {
+        int screen_x = GRID_X_OFFSET + active->grid_x * GRID_CELL_SIZE;
+        int screen_y = GRID_Y_OFFSET + active->grid_y * GRID_CELL_SIZE;
+        set_active_tint(active);
+        draw_tetris_piece_sized(screen_x, screen_y,
+            active->piece_type, 1, GRID_CELL_SIZE, 0);
+    }
+}
+
+void grid_draw_cell(int x, int y)
+{
+    int screen_x = GRID_X_OFFSET + x * GRID_CELL_SIZE;
+    int screen_y = GRID_Y_OFFSET + y * GRID_CELL_SIZE;
+
+    // A cell owns its square, including the grid lines on its left and top
+    // edges; the right and bottom border lines are never covered by tiles
+    background_restore(screen_x, screen_y, GRID_CELL_SIZE, GRID_CELL_SIZE);
+
+    if (grid_get_occupancy() & GRID_BIT(x, y))
+    {
+        renderer_set_tile_color(grid_get_cell_color(x, y));
+        draw_filled_cell(x, y);
+    }
+
+    // The active block's tile covers the whole square, locked tile included
+    const placed_block_t *active = grid_get_active_placed_block();
+    if (active && (piece_catalog_mask_at(active->piece_type, active->grid_x, active->grid_y) & GRID_BIT(x, y)))
+    {
+        set_active_tint(active);
+        renderer_draw_beveled_tile(screen_x, screen_y, GRID_CELL_SIZE, 1);
+    }
+}
+
+void grid_draw_score(void)
+{
+    score_draw();
+}
+
+int grid_particles_active(void)
+{
+    return particle_task_id >= 0;
+}
+
+void grid_draw_particles(void)
+{
+    particles_draw(COLOR_TETRIS_RED);
+}
+
+static int line_clear_task_id = -1;
+static void (*line_clear_done)(void) = NULL;
+
+static void end_line_clear(void)
+{
+    void (*done)(void) = line_clear_done;
+    line_clear_task_id = -1;
+    line_clear_done = NULL;
+    if (done) done();
+}
+
+// Scheduler task: one step of the sweep per tick, bursting every cleared cell
+static int line_clear_step(void *data)
+{
+    (void)data;
+    uint64_t cleared = grid_clear_step();
+    for (int bit = 0; cleared; bit++, cleared >>= 1)
+    {
+        if (cleared & 1) spawn_cell_explosion(bit % GRID_SIZE, bit / GRID_SIZE);
+    }
+    if (particle_task_id < 0) particle_task_id = frame_sched_add(particles_task, NULL);
+
+    if (grid_clear_pending()) return 1;
+    end_line_clear();
+    return 0;
+}
+
+void grid_start_line_clear(void (*done)(void))
+{
+    grid_skip_line_clear();
+
+    line_clear_done = done;
+    if (grid_clear_pending())
+    {
+        line_clear_task_id = frame_sched_add(line_clear_step, NULL);
+        if (line_clear_task_id >= 0) return;
+        // No free task slot: clear without the animation
+        grid_clear_finish();
+    }
+    end_line_clear();
+}
+
+int grid_line_clear_running(void)
+{
+    return line_clear_task_id >= 0;
+}
+
+void grid_skip_line_clear(void)
+{
+    if (line_clear_task_id < 0) return;
+    frame_sched_cancel(line_clear_task_id);
+    grid_clear_finish();
+    end_line_clear();
+}
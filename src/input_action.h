@@ -0,0 +1,21 @@
+#ifndef INPUT_ACTION_H
+#define INPUT_ACTION_H
+
+// What a key does to the game. The values are stored in replays (replay.h):
+// only append new actions
+typedef enum {
+    INPUT_ACTION_NONE = 0,
+    INPUT_ACTION_EXIT,
+    INPUT_ACTION_RESET,
+    INPUT_ACTION_PLACE_BLOCK,
+    INPUT_ACTION_MOVE_UP,
+    INPUT_ACTION_MOVE_DOWN,
+    INPUT_ACTION_MOVE_LEFT,
+    INPUT_ACTION_MOVE_RIGHT,
+    INPUT_ACTION_SELECT_UP,
+    INPUT_ACTION_SELECT_DOWN,
+    INPUT_ACTION_TOGGLE_PROFILER, // F5, PROFILER builds only
+    INPUT_ACTION_DUMP_LATENCY     // F4, PROFILER builds only
+} input_action_t;
+
+#endif // INPUT_ACTION_H
@@ -1,13 +1,22 @@
 #include <gint/display.h>
 #include <gint/keyboard.h>
+#include <gint/gint.h>
 #include "input_handler.h"
 #include "game_state.h"
 #include "grid.h"
 #include "tetris_blocks.h"
 #include "renderer.h"
+#include "profiler.h"
+#include "input_latency.h"
+#include "replay.h"
+#include "score.h"
+#include "frame_clock.h"
+#include "frame_sched.h"
+#include <time.h>
 
 input_action_t input_handle_key(key_event_t key)
 {
+    LATENCY_KEY();
     switch (key.key)
     {
         case KEY_EXIT:
@@ -26,187 +35,246 @@ input_action_t input_handle_key(key_event_t key)
             return INPUT_ACTION_MOVE_LEFT;
         case KEY_RIGHT:
             return INPUT_ACTION_MOVE_RIGHT;
+#ifdef PROFILER
+        case KEY_F5:
+            return INPUT_ACTION_TOGGLE_PROFILER;
+        case KEY_F4:
+            return INPUT_ACTION_DUMP_LATENCY;
+#endif
         default:
             return INPUT_ACTION_NONE;
     }
 }
 
+// End of a turn, once the line clear sweep of the locked block is over
+static void finish_turn(void)
+{
+    // Regenerate pieces if needed after placing
+    game_state_finish_turn();
+    PROFILE_ENTER(PROF_GAME_OVER);
+    game_state_check_game_over();
+    PROFILE_LEAVE(PROF_GAME_OVER);
+    replay_record_turn();
+}
+
 void input_process_action(input_action_t action)
 {
+    // A key press cuts a running line clear sweep short so the action
+    // applies to the settled grid
+    if (action != INPUT_ACTION_NONE) grid_skip_line_clear();
+    replay_record_action(action);
+
+    // Actions only change the game state; the main loop presents the frame,
+    // repainting just what changed
     switch (action)
     {
         case INPUT_ACTION_EXIT:
             // If there's an active block being placed, cancel it and return piece to sidebar
-            if (grid_get_active_block() != -1)
-            {
-                uint16_t color = grid_get_active_block_color();
-                int piece_type = grid_cancel_active_block();
-                if (piece_type >= 0)
-                {
-                    tetris_blocks_restore_piece_with_color(piece_type, color);
-                }
-                // Redraw everything after canceling
-                dclear(COLOR_BACKGROUND);
-                grid_draw();
-                grid_draw_placed_blocks();
-                grid_draw_score();
-                tetris_blocks_draw();
-                renderer_draw_footer();
-                dupdate();
-            }
-            else
-            {
-                // Clean exit without calling game_reset to avoid display issues
-                return;
-            }
+            // (otherwise nothing to do; exiting is handled by the MENU key)
+            game_state_cancel_active();
             break;
             
         case INPUT_ACTION_RESET:
-            game_state_reset();
+            input_new_game((uint32_t)clock());
+            renderer_invalidate();
             break;
             
         case INPUT_ACTION_PLACE_BLOCK:
             if (grid_get_active_block() != -1)
             {
-                // If active block overlaps an existing block, ignore EXE
-                if (!grid_active_overlaps_existing())
+                // Lock current active block in place unless it overlaps an existing block
+                // The sweep then plays over the next frames and the turn
+                // ends with it
+                if (game_state_place_active() >= 0)
                 {
-                    // Lock current active block in place (stays red)
-                    grid_finalize_active_block();
-                    // Regenerate pieces if needed after placing
-                    tetris_blocks_regenerate_if_needed();
+                    grid_start_line_clear(finish_turn);
                 }
+                break;
             }
             else
             {
                 // Spawn selected piece at top left corner and make it active
-                int current_selection = tetris_blocks_get_selection();
-                int piece_type = tetris_blocks_get_piece_type_for_selection(current_selection);
-                if (piece_type < 0)
-                {
-                    // No available selection; try to regenerate if all consumed
-                    tetris_blocks_regenerate_if_needed();
-                    // Re-evaluate selection after potential regeneration
-                    current_selection = tetris_blocks_get_selection();
-                    piece_type = tetris_blocks_get_piece_type_for_selection(current_selection);
-                    if (piece_type < 0)
-                    {
-                        // Still nothing to place
-                        dclear(COLOR_BACKGROUND);
-                        grid_draw();
-                        grid_draw_placed_blocks();
-                        grid_draw_score();
-                        tetris_blocks_draw();
-                        renderer_draw_footer();
-                        dupdate();
-                        return;
-                    }
-                }
-                // Always place at top left corner (0, 0)
-                int px = 0, py = 0;
-                // Check if piece can fit at top left corner
-                if (!grid_is_valid_position(piece_type, px, py))
+                if (!game_state_pick_selected())
                 {
-                    // Piece doesn't fit at top left, skip placement
-                    dupdate();
+                    // Nothing to place
                     return;
                 }
-                // Determine the color assigned to this selected slot
-                uint16_t color = tetris_blocks_get_piece_color_for_slot(current_selection);
-                grid_place_block(piece_type, px, py, color);
-                // Consume the sidebar piece used
-                tetris_blocks_consume_selected();
             }
-            // Redraw everything
-            dclear(COLOR_BACKGROUND);
-            grid_draw();
-            grid_draw_placed_blocks();
-            grid_draw_score();
-            tetris_blocks_draw();
-            renderer_draw_footer();
             
             // Check for game over after piece placement
+            PROFILE_ENTER(PROF_GAME_OVER);
             game_state_check_game_over();
+            PROFILE_LEAVE(PROF_GAME_OVER);
             break;
             
         case INPUT_ACTION_MOVE_UP:
-            if (grid_get_active_block() != -1)
-            {
-                grid_move_active_block(0, -1);  // Move up
-            }
-            else
-            {
-                // Otherwise, change block selection
-                int current_selection = tetris_blocks_get_selection();
-                if (current_selection > 0)
-                {
-                    tetris_blocks_set_selection(current_selection - 1);
-                }
-            }
-            // Redraw everything
-            dclear(COLOR_BACKGROUND);
-            grid_draw();
-            grid_draw_placed_blocks();
-            grid_draw_score();
-            tetris_blocks_draw();
-            renderer_draw_footer();
+            // Move up, or change block selection if nothing is active
+            game_state_move(0, -1);
             break;
             
         case INPUT_ACTION_MOVE_DOWN:
-            if (grid_get_active_block() != -1)
-            {
-                grid_move_active_block(0, 1);  // Move down
-            }
-            else
-            {
-                // Otherwise, change block selection
-                int current_selection = tetris_blocks_get_selection();
-                if (current_selection < 2)  // We have 3 blocks (0, 1, 2)
-                {
-                    tetris_blocks_set_selection(current_selection + 1);
-                }
-            }
-            // Redraw everything
-            dclear(COLOR_BACKGROUND);
-            grid_draw();
-            grid_draw_placed_blocks();
-            grid_draw_score();
-            tetris_blocks_draw();
-            renderer_draw_footer();
+            // Move down, or change block selection if nothing is active
+            game_state_move(0, 1);
             break;
             
         case INPUT_ACTION_MOVE_LEFT:
-            if (grid_get_active_block() != -1)
-            {
-                grid_move_active_block(-1, 0);  // Move left
-            }
-            // Redraw everything
-            dclear(COLOR_BACKGROUND);
-            grid_draw();
-            grid_draw_placed_blocks();
-            grid_draw_score();
-            tetris_blocks_draw();
-            renderer_draw_footer();
+            game_state_move(-1, 0);  // Move left
             break;
             
         case INPUT_ACTION_MOVE_RIGHT:
-            if (grid_get_active_block() != -1)
-            {
-                grid_move_active_block(1, 0);  // Move right
-            }
-            // Redraw everything
-            dclear(COLOR_BACKGROUND);
-            grid_draw();
-            grid_draw_placed_blocks();
-            grid_draw_score();
-            tetris_blocks_draw();
-            renderer_draw_footer();
+            game_state_move(1, 0);  // Move right
             break;
             
+#ifdef PROFILER
+        case INPUT_ACTION_TOGGLE_PROFILER:
+            profiler_toggle_overlay();
+            // Hiding the box leaves it on screen until a full repaint
+            renderer_invalidate();
+            break;
+
+        case INPUT_ACTION_DUMP_LATENCY:
+            // Key-to-display histogram so far, next to /score.txt
+            input_latency_dump("/latency.txt");
+            break;
+#endif
+
         case INPUT_ACTION_NONE:
         default:
             break;
     }
 }
 
-// yeah i fucking know redrawing everything after a single action is bad but im lazy
\ No newline at end of file
+// --- Event loop ---
+
+// Moves read this frame, applied as one net displacement
+static int8_t step_dx[INPUT_MAX_STEPS];
+static int8_t step_dy[INPUT_MAX_STEPS];
+static int num_steps = 0;
+
+// Arrow key held down, repeated on frame clock ticks
+static int held_key = 0;
+static input_action_t held_action = INPUT_ACTION_NONE;
+static uint32_t next_repeat = 0;
+
+static int is_move(input_action_t action)
+{
+    return action == INPUT_ACTION_MOVE_UP || action == INPUT_ACTION_MOVE_DOWN ||
+           action == INPUT_ACTION_MOVE_LEFT || action == INPUT_ACTION_MOVE_RIGHT;
+}
+
+static void flush_steps(void)
+{
+    if (!num_steps) return;
+    // Like any other action, a move cuts a running sweep short
+    grid_skip_line_clear();
+    // Recorded only now: a keyframe taken as the sweep ends must not count
+    // moves that come after it
+    for (int i = 0; i < num_steps; i++)
+    {
+        replay_record_action(step_dx[i] < 0 ? INPUT_ACTION_MOVE_LEFT : step_dx[i] > 0 ? INPUT_ACTION_MOVE_RIGHT :
+                             step_dy[i] < 0 ? INPUT_ACTION_MOVE_UP : INPUT_ACTION_MOVE_DOWN);
+    }
+    game_state_move_path(step_dx, step_dy, num_steps);
+    num_steps = 0;
+}
+
+static void add_step(input_action_t action)
+{
+    if (num_steps == INPUT_MAX_STEPS) flush_steps();
+    step_dx[num_steps] = action == INPUT_ACTION_MOVE_LEFT ? -1 : action == INPUT_ACTION_MOVE_RIGHT ? 1 : 0;
+    step_dy[num_steps] = action == INPUT_ACTION_MOVE_UP ? -1 : action == INPUT_ACTION_MOVE_DOWN ? 1 : 0;
+    num_steps++;
+}
+
+// SHIFT pressed, waiting for the next key
+static int shift_pending = 0;
+
+// What getkey() did by itself before the loop read raw events: MENU goes
+// to the OS main menu and SHIFT then AC/ON powers off. Returns 1 if the
+// key was one of those
+static int handle_system_key(key_event_t ev)
+{
+    int shift = shift_pending;
+    shift_pending = ev.key == KEY_SHIFT;
+    if (ev.key == KEY_MENU)
+    {
+        gint_osmenu();
+    }
+    else if (shift && ev.key == KEY_ACON)
+    {
+        gint_poweroff(true);
+    }
+    else
+    {
+        return ev.key == KEY_SHIFT;
+    }
+
+    // Back in the add-in: nothing on screen or held can be trusted
+    held_key = 0;
+    renderer_invalidate();
+    return 1;
+}
+
+static int handle_event(key_event_t ev)
+{
+    if (ev.type == KEYEV_UP && ev.key == held_key) held_key = 0;
+    if (ev.type != KEYEV_DOWN) return 0;
+    if (handle_system_key(ev)) return 0;
+
+    input_action_t action = input_handle_key(ev);
+    if (is_move(action))
+    {
+        add_step(action);
+        held_key = ev.key;
+        held_action = action;
+        next_repeat = frame_clock_now() + INPUT_REPEAT_DELAY;
+        return 0;
+    }
+
+    // Moves read before this key happen before it
+    flush_steps();
+    input_process_action(action);
+    if (ev.key == KEY_F3) return INPUT_SAW_F3;
+    return ev.key == KEY_F6 ? INPUT_SAW_F6 : 0;
+}
+
+int input_poll_frame(void)
+{
+    // Sleep until a key event, or until the next frame tick while an
+    // animation plays or an arrow key repeats
+    int wake_on_tick = frame_sched_busy() || held_key;
+    key_event_t ev = waitevent(wake_on_tick ? frame_clock_wakeup() : NULL);
+
+    // Then take everything queued, stopping at game over so the keys that
+    // follow go to the game over screen
+    int seen = 0;
+    while (ev.type != KEYEV_NONE)
+    {
+        seen |= handle_event(ev);
+        if (game_state_is_over()) break;
+        ev = pollevent();
+    }
+
+    // One repeat per tick once the key has been down long enough
+    if (held_key && !keydown(held_key)) held_key = 0;
+    if (held_key && !game_state_is_over())
+    {
+        uint32_t now = frame_clock_now();
+        while ((int32_t)(now - next_repeat) >= 0)
+        {
+            add_step(held_action);
+            next_repeat += INPUT_REPEAT_PERIOD;
+        }
+    }
+
+    flush_steps();
+    return seen;
+}
+
+void input_new_game(uint32_t seed)
+{
+    // The game left behind is saved as it stands
+    replay_record_save(REPLAY_PATH, (uint32_t)score_get_current());
+    game_state_reset(seed);
+    replay_record_start(seed);
+}
@@ -2,22 +2,32 @@
 #define INPUT_HANDLER_H
 
 #include <gint/keyboard.h>
+#include <stdint.h>
+#include "input_action.h"
 
 // Input handling
-typedef enum {
-    INPUT_ACTION_NONE = 0,
-    INPUT_ACTION_EXIT,
-    INPUT_ACTION_RESET,
-    INPUT_ACTION_PLACE_BLOCK,
-    INPUT_ACTION_MOVE_UP,
-    INPUT_ACTION_MOVE_DOWN,
-    INPUT_ACTION_MOVE_LEFT,
-    INPUT_ACTION_MOVE_RIGHT,
-    INPUT_ACTION_SELECT_UP,
-    INPUT_ACTION_SELECT_DOWN
-} input_action_t;
-
 input_action_t input_handle_key(key_event_t key);
 void input_process_action(input_action_t action);
 
+// Event loop: held arrows repeat after INPUT_REPEAT_DELAY frame ticks, then
+// every INPUT_REPEAT_PERIOD ticks
+#define INPUT_REPEAT_DELAY 12
+#define INPUT_REPEAT_PERIOD 1
+// Moves folded into one displacement at most
+#define INPUT_MAX_STEPS 32
+// Keys input_poll_frame() leaves to the main loop
+#define INPUT_SAW_F6 0x01
+#define INPUT_SAW_F3 0x02
+
+// Wait for key events, or for the next frame tick while animations run,
+// then apply every queued event; consecutive moves are folded into one
+// displacement (game_state_move_path) so a burst of arrows costs one frame.
+// MENU and SHIFT then AC/ON leave for the OS as they do in getkey().
+// Returns the INPUT_SAW_* keys seen
+int input_poll_frame(void);
+
+// Start a new game from seed and record it for replay (replay.h); the
+// add-in seeds from clock()
+void input_new_game(uint32_t seed);
+
 #endif // INPUT_HANDLER_H
@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include "input_latency.h"
+#include "profiler.h"
+
+static latency_hist_t hist;
+static profiler_stamp_t pending[INPUT_LATENCY_PENDING];
+static int num_pending = 0;
+
+void input_latency_reset(void)
+{
+    latency_hist_init(&hist);
+    num_pending = 0;
+}
+
+void input_latency_key(void)
+{
+    if (num_pending < INPUT_LATENCY_PENDING) pending[num_pending++] = profiler_stamp();
+}
+
+void input_latency_shown(void)
+{
+    for (int i = 0; i < num_pending; i++)
+    {
+        latency_hist_add(&hist, profiler_since_ns(pending[i]));
+    }
+    num_pending = 0;
+}
+
+const latency_hist_t *input_latency_hist(void)
+{
+    return &hist;
+}
+
+int input_latency_dump(const char *path)
+{
+    FILE *fp = fopen(path, "w");
+    if (!fp) return 0;
+
+    fprintf(fp, "keys %llu\n", (unsigned long long)hist.count);
+    fprintf(fp, "min_us %llu\n", (unsigned long long)(hist.count ? hist.min / 1000 : 0));
+    fprintf(fp, "mean_us %llu\n", (unsigned long long)(latency_hist_mean(&hist) / 1000));
+    fprintf(fp, "max_us %llu\n", (unsigned long long)(hist.max / 1000));
+    // One line per percent, e.g. to plot the distribution
+    fprintf(fp, "percentile,us\n");
+    for (int p = 1; p <= 100; p++)
+    {
+        uint64_t ns = latency_hist_quantile(&hist, p / 100.0);
+        fprintf(fp, "%d,%llu\n", p, (unsigned long long)(ns / 1000));
+    }
+
+    int ok = !ferror(fp);
+    if (fclose(fp)) ok = 0;
+    return ok;
+}
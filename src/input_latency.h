@@ -0,0 +1,32 @@
+#ifndef INPUT_LATENCY_H
+#define INPUT_LATENCY_H
+
+#include "latency_hist.h"
+
+// Key-to-display latency, built only with the PROFILER option: every key
+// event is stamped when input_handle_key() receives it, and its sample is
+// taken once the frame showing its effect has been pushed to the LCD (or
+// renderer_present() found nothing to repaint). Samples are in nanoseconds
+// and go to one histogram for the whole run
+
+#ifdef PROFILER
+#define LATENCY_KEY() input_latency_key()
+#define LATENCY_SHOWN() input_latency_shown()
+#else
+#define LATENCY_KEY() ((void)0)
+#define LATENCY_SHOWN() ((void)0)
+#endif
+
+// Key events a frame can carry; further ones in the same frame are not timed
+#define INPUT_LATENCY_PENDING 32
+
+void input_latency_reset(void);
+// A key event arrived
+void input_latency_key(void);
+// The display is up to date with every key received so far
+void input_latency_shown(void);
+const latency_hist_t *input_latency_hist(void);
+// Write the summary and the quantiles in microseconds; returns 0 on error
+int input_latency_dump(const char *path);
+
+#endif // INPUT_LATENCY_H
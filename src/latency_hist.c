@@ -0,0 +1,76 @@
+#include <string.h>
+#include "latency_hist.h"
+
+// bucket index: values below LATENCY_HIST_SUB map to themselves, larger ones
+// to (exponent, top LATENCY_HIST_SUB_BITS bits of the mantissa)
+static int bucket_of(uint64_t value)
+{
+    if (value < LATENCY_HIST_SUB) return (int)value;
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - LATENCY_HIST_SUB_BITS;
+    int sub = (int)((value >> shift) & (LATENCY_HIST_SUB - 1));
+    return (shift + 1) * LATENCY_HIST_SUB + sub;
+}
+
+// largest value that falls into bucket
+static uint64_t bucket_upper(int bucket)
+{
+    if (bucket < LATENCY_HIST_SUB) return (uint64_t)bucket;
+    int shift = bucket / LATENCY_HIST_SUB - 1;
+    uint64_t sub = (uint64_t)(bucket % LATENCY_HIST_SUB);
+    uint64_t base = (LATENCY_HIST_SUB + sub) << shift;
+    return base + ((uint64_t)1 << shift) - 1;
+}
+
+void latency_hist_init(latency_hist_t *hist)
+{
+    memset(hist, 0, sizeof(*hist));
+    hist->min = UINT64_MAX;
+}
+
+void latency_hist_add(latency_hist_t *hist, uint64_t value)
+{
+    hist->buckets[bucket_of(value)]++;
+    hist->count++;
+    hist->sum += value;
+    if (value < hist->min) hist->min = value;
+    if (value > hist->max) hist->max = value;
+}
+
+void latency_hist_merge(latency_hist_t *dst, const latency_hist_t *src)
+{
+    for (int i = 0; i < LATENCY_HIST_BUCKETS; i++)
+    {
+        dst->buckets[i] += src->buckets[i];
+    }
+    dst->count += src->count;
+    dst->sum += src->sum;
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+}
+
+uint64_t latency_hist_quantile(const latency_hist_t *hist, double q)
+{
+    if (hist->count == 0) return 0;
+    if (q < 0) q = 0;
+    if (q > 1) q = 1;
+
+    uint64_t rank = (uint64_t)(q * (double)(hist->count - 1)) + 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < LATENCY_HIST_BUCKETS; i++)
+    {
+        seen += hist->buckets[i];
+        if (seen >= rank)
+        {
+            uint64_t upper = bucket_upper(i);
+            return upper < hist->max ? upper : hist->max;
+        }
+    }
+    return hist->max;
+}
+
+double latency_hist_mean(const latency_hist_t *hist)
+{
+    if (hist->count == 0) return 0;
+    return (double)hist->sum / (double)hist->count;
+}
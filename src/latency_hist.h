@@ -0,0 +1,32 @@
+#ifndef LATENCY_HIST_H
+#define LATENCY_HIST_H
+
+#include <stdint.h>
+
+// Fixed-size log-linear latency histogram: every power of two is split into
+// LATENCY_HIST_SUB buckets, so quantiles are within ~1/LATENCY_HIST_SUB of the
+// true value and memory does not grow with the number of samples
+#define LATENCY_HIST_SUB_BITS 4
+#define LATENCY_HIST_SUB (1 << LATENCY_HIST_SUB_BITS)
+#define LATENCY_HIST_BUCKETS (64 * LATENCY_HIST_SUB)
+
+typedef struct {
+    uint64_t buckets[LATENCY_HIST_BUCKETS];
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+} latency_hist_t;
+
+void latency_hist_init(latency_hist_t *hist);
+void latency_hist_add(latency_hist_t *hist, uint64_t value);
+// Add every sample of src into dst
+void latency_hist_merge(latency_hist_t *dst, const latency_hist_t *src);
+// Value at quantile q in [0, 1] (upper edge of its bucket), 0 if empty
+uint64_t latency_hist_quantile(const latency_hist_t *hist, double q);
+double latency_hist_mean(const latency_hist_t *hist);
+
+// Monotonic clock in nanoseconds, host tools only (host/latency_clock.c)
+uint64_t latency_now_ns(void);
+
+#endif // LATENCY_HIST_H
@@ -1,6 +1,7 @@
 #include <gint/display.h>
 #include <gint/keyboard.h>
 #include <stdio.h>
+#include <time.h>
 #include "game_state.h"
 #include "input_handler.h"
 #include "renderer.h"
@@ -8,10 +9,22 @@
 #include "score.h"
 #include "renderer.h"
 #include "tetris_blocks.h"
+#include "background.h"
+#include "frame_sched.h"
+#include "profiler.h"
+#include "input_latency.h"
+#include "replay.h"
+#include "replay_view.h"
 
 int main(void)
 {
-    game_state_reset();
+    renderer_init();
+    frame_sched_init();
+#ifdef PROFILER
+    profiler_init();
+    input_latency_reset();
+#endif
+    input_new_game((uint32_t)clock());
     // Ensure score file exists in calculator's main directory
     {
         const char *path = "/score.txt";
@@ -42,13 +55,16 @@ int main(void)
         // if gameover show game over screen and wait for reset which ISNT FUCKING WORKING
         if (game_state_is_over())
         {
-            dclear(COLOR_BACKGROUND);
-            grid_draw();
+            // Append the finished game to the replay file (once)
+            replay_record_save(REPLAY_PATH, (uint32_t)score_get_current());
+
+            background_draw();
             grid_draw_placed_blocks();
             grid_draw_score();
             renderer_draw_game_over();
             renderer_draw_footer();
             dupdate();
+            renderer_invalidate();
             
             // Wait for key press
             key_event_t key = getkey();
@@ -62,20 +78,27 @@ int main(void)
             // reset the game
             if(key.key == KEY_F1 || key.key == KEY_F2)
             {
-                game_state_reset();
+                input_new_game((uint32_t)clock());
+                renderer_redraw_all();
             }
             continue;
         }
         
-        // wait for key press
-        key_event_t key = getkey();
+        // Apply every key event queued since the last frame, sleeping until
+        // there is one (or the next tick while animations run)
+        int keys = input_poll_frame();
+        
+        // Step the animations for the ticks that passed
+        frame_sched_update();
         
-        // process the input
-        input_action_t action = input_handle_key(key);
-        input_process_action(action);
+        // On F3, browse the saved games
+        if(keys & INPUT_SAW_F3)
+        {
+            replay_view_run();
+        }
         
         // On F6, write the current score to /score.txt
-        if(key.key == KEY_F6)
+        if(keys & INPUT_SAW_F6)
         {
             int current = score_get_current();
             // Read latest saved score from file and only save if current > latest
@@ -101,18 +124,12 @@ int main(void)
                     fclose(fw);
                     // Update loaded to current so 'unsaved' disappears
                     score_set_loaded(current);
-                    // Quick redraw of right panel to reflect changes
-                    dclear(COLOR_BACKGROUND);
-                    grid_draw();
-                    grid_draw_placed_blocks();
-                    grid_draw_score();
-                    tetris_blocks_draw();
-                    renderer_draw_footer();
                 }
             }
         }
         
-        dupdate();
+        // Repaint what changed; unchanged frames skip drawing and dupdate
+        renderer_present();
     }
     
     return 0;
@@ -0,0 +1,22 @@
+#include "oracle.h"
+#include "piece_catalog.h"
+
+int oracle_piece_fits(uint64_t occupied, int piece_type)
+{
+    return piece_catalog_free_anchors(piece_type, occupied) != 0;
+}
+
+int oracle_any_piece_fits(uint64_t occupied, const int pieces[], int num_pieces)
+{
+    for (int i = 0; i < num_pieces; i++)
+    {
+        if (oracle_piece_fits(occupied, pieces[i])) return 1;
+    }
+    return 0;
+}
+
+int oracle_worst_case_ops(void)
+{
+    // one shift+OR per cell and a final AND for each of the 3 sidebar pieces
+    return 3 * (2 * piece_catalog_max_cells() + 1);
+}
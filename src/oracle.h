@@ -0,0 +1,16 @@
+#ifndef ORACLE_H
+#define ORACLE_H
+
+#include <stdint.h>
+
+// Game-over oracle: answers "can any of these pieces be placed on this
+// occupancy bitboard" with a fixed number of word operations per piece
+
+// Returns 1 if at least one piece has a legal, non-overlapping anchor
+int oracle_any_piece_fits(uint64_t occupied, const int pieces[], int num_pieces);
+// Returns 1 if piece_type has a legal, non-overlapping anchor
+int oracle_piece_fits(uint64_t occupied, int piece_type);
+// Worst-case number of shift/OR/AND word operations for a full sidebar check
+int oracle_worst_case_ops(void);
+
+#endif // ORACLE_H
@@ -0,0 +1,96 @@
+#include <gint/display.h>
+#include "particles.h"
+#include "span.h"
+
+// 7 bytes per particle; velocities stay within int8_t (at most ~16 px per
+// step) and positions within int16_t for any life up to 255 steps
+static int16_t pos_x[PARTICLES_MAX];
+static int16_t pos_y[PARTICLES_MAX];
+static int8_t vel_x[PARTICLES_MAX];
+static int8_t vel_y[PARTICLES_MAX];
+static uint8_t life_left[PARTICLES_MAX];
+static int live = 0;
+
+static int clamp8(int v)
+{
+    if (v > INT8_MAX) return INT8_MAX;
+    if (v < INT8_MIN) return INT8_MIN;
+    return v;
+}
+
+void particles_clear(void)
+{
+    live = 0;
+}
+
+int particles_spawn(int x, int y, int vx, int vy, int life)
+{
+    if (live >= PARTICLES_MAX || life <= 0) return 0;
+    pos_x[live] = (int16_t)x;
+    pos_y[live] = (int16_t)y;
+    vel_x[live] = (int8_t)clamp8(vx);
+    vel_y[live] = (int8_t)clamp8(vy);
+    life_left[live] = (uint8_t)(life > 255 ? 255 : life);
+    live++;
+    return 1;
+}
+
+// Move the last live particle into slot i
+static void kill(int i)
+{
+    live--;
+    pos_x[i] = pos_x[live];
+    pos_y[i] = pos_y[live];
+    vel_x[i] = vel_x[live];
+    vel_y[i] = vel_y[live];
+    life_left[i] = life_left[live];
+}
+
+int particles_step(void)
+{
+    int i = 0;
+    while (i < live)
+    {
+        int vy = vel_y[i];
+        pos_x[i] += vel_x[i];
+        pos_y[i] += vy;
+        vel_y[i] = (int8_t)clamp8(vy + PARTICLE_GRAVITY);
+
+        // Falling below the screen never comes back
+        if (--life_left[i] == 0 || (vy >= 0 && pos_y[i] >= DHEIGHT * PARTICLE_ONE))
+        {
+            kill(i);
+            continue;
+        }
+        i++;
+    }
+    return live;
+}
+
+int particles_count(void)
+{
+    return live;
+}
+
+void particles_draw(uint16_t color)
+{
+    for (int i = 0; i < live; i++)
+    {
+        int x = pos_x[i] >> PARTICLE_FRAC;
+        int y = pos_y[i] >> PARTICLE_FRAC;
+
+        // Fully visible squares are four plain stores; the rest are clipped
+        if ((unsigned)x < DWIDTH - 1 && (unsigned)y < DHEIGHT - 1)
+        {
+            uint16_t *p = gint_vram + y * DWIDTH + x;
+            p[0] = color;
+            p[1] = color;
+            p[DWIDTH] = color;
+            p[DWIDTH + 1] = color;
+        }
+        else
+        {
+            span_rect(x, y, 2, 2, color);
+        }
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <stdint.h>
+
+// Pool of 2x2 particles stored as parallel arrays. Live particles are kept
+// packed at the front, so spawning appends and a dying particle is replaced
+// by the last one: both O(1), and updates only touch live entries
+
+#define PARTICLES_MAX 1024
+// Positions and velocities are fixed-point with PARTICLE_FRAC sub-pixel bits
+#define PARTICLE_FRAC 3
+#define PARTICLE_ONE (1 << PARTICLE_FRAC)
+// Added to the vertical velocity every step
+#define PARTICLE_GRAVITY PARTICLE_ONE
+
+void particles_clear(void);
+// Add a particle at (x, y) moving by (vx, vy) per step, all in 1/PARTICLE_ONE
+// pixels, for life steps; returns 0 if the pool is full
+int particles_spawn(int x, int y, int vx, int vy, int life);
+// Move and age every live particle; returns how many are still alive
+int particles_step(void);
+int particles_count(void);
+// Draw every live particle as a 2x2 square
+void particles_draw(uint16_t color);
+
+#endif // PARTICLES_H
@@ -0,0 +1,158 @@
+#include <stddef.h>
+#include "piece_catalog.h"
+#include "grid.h"
+#include "tetris_blocks.h"
+
+// Shapes are stored at the index of their canonical piece type
+static piece_shape_t catalog_shapes[TETRIS_PIECES];
+static piece_info_t catalog_pieces[TETRIS_PIECES];
+static int catalog_num_shapes = 0;
+static int catalog_max_cells = 0;
+static int catalog_ready = 0;
+
+// trim the 4x4 definition of a piece into shape, returning its box offset
+static void trim_piece(int piece_type, piece_shape_t *shape, int *box_col, int *box_row)
+{
+    int min_row = 4, max_row = -1, min_col = 4, max_col = -1;
+    for (int row = 0; row < 4; row++)
+    {
+        for (int col = 0; col < 4; col++)
+        {
+            if (!tetris_piece_cell(piece_type, row, col)) continue;
+            if (row < min_row) min_row = row;
+            if (row > max_row) max_row = row;
+            if (col < min_col) min_col = col;
+            if (col > max_col) max_col = col;
+        }
+    }
+
+    shape->width = max_col - min_col + 1;
+    shape->height = max_row - min_row + 1;
+    shape->num_cells = 0;
+    shape->mask = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        shape->row_cells[i] = 0;
+        shape->col_cells[i] = 0;
+    }
+    for (int row = min_row; row <= max_row; row++)
+    {
+        for (int col = min_col; col <= max_col; col++)
+        {
+            if (!tetris_piece_cell(piece_type, row, col)) continue;
+            int dx = col - min_col;
+            int dy = row - min_row;
+            shape->cells[shape->num_cells].dx = (int8_t)dx;
+            shape->cells[shape->num_cells].dy = (int8_t)dy;
+            shape->offsets[shape->num_cells] = (uint8_t)(dy * GRID_SIZE + dx);
+            shape->mask |= GRID_BIT(dx, dy);
+            shape->row_cells[dy]++;
+            shape->col_cells[dx]++;
+            shape->num_cells++;
+        }
+    }
+
+    // anchors whose box stays inside the grid
+    shape->anchors = 0;
+    shape->num_anchors = 0;
+    for (int y = 0; y + shape->height <= GRID_SIZE; y++)
+    {
+        for (int x = 0; x + shape->width <= GRID_SIZE; x++)
+        {
+            shape->anchors |= GRID_BIT(x, y);
+            shape->num_anchors++;
+        }
+    }
+
+    *box_col = min_col;
+    *box_row = min_row;
+}
+
+void piece_catalog_init(void)
+{
+    if (catalog_ready) return;
+
+    catalog_num_shapes = 0;
+    catalog_max_cells = 0;
+    for (int p = 0; p < TETRIS_PIECES; p++)
+    {
+        piece_shape_t shape;
+        piece_info_t *info = &catalog_pieces[p];
+        trim_piece(p, &shape, &info->box_col, &info->box_row);
+
+        // collapse onto an earlier piece type with the same trimmed shape
+        info->canonical = p;
+        for (int q = 0; q < p; q++)
+        {
+            const piece_shape_t *other = &catalog_shapes[q];
+            if (catalog_pieces[q].canonical == q && other->mask == shape.mask &&
+                other->width == shape.width && other->height == shape.height)
+            {
+                info->canonical = q;
+                break;
+            }
+        }
+
+        if (info->canonical == p)
+        {
+            catalog_shapes[p] = shape;
+            catalog_num_shapes++;
+            if (shape.num_cells > catalog_max_cells) catalog_max_cells = shape.num_cells;
+        }
+        info->shape = &catalog_shapes[info->canonical];
+    }
+    catalog_ready = 1;
+}
+
+const piece_info_t *piece_catalog_get(int piece_type)
+{
+    if (piece_type < 0 || piece_type >= TETRIS_PIECES) return NULL;
+    return &catalog_pieces[piece_type];
+}
+
+int piece_catalog_num_shapes(void)
+{
+    return catalog_num_shapes;
+}
+
+int piece_catalog_max_cells(void)
+{
+    return catalog_max_cells;
+}
+
+uint64_t piece_catalog_mask_at(int piece_type, int gx, int gy)
+{
+    const piece_info_t *info = piece_catalog_get(piece_type);
+    if (!info) return 0;
+
+    int x = gx + info->box_col;
+    int y = gy + info->box_row;
+    if (x <= -GRID_SIZE || y <= -GRID_SIZE || x >= GRID_SIZE || y >= GRID_SIZE) return 0;
+
+    uint64_t m = info->shape->mask;
+    // drop the columns that would wrap into the neighbouring row, then shift
+    if (x > 0)
+        m = (m & (GRID_COL_MASK * (0xFFu >> x))) << x;
+    else if (x < 0)
+        m = (m & (GRID_COL_MASK * ((0xFFu << -x) & 0xFFu))) >> -x;
+    if (y > 0)
+        m <<= y * GRID_SIZE;
+    else if (y < 0)
+        m >>= -y * GRID_SIZE;
+    return m;
+}
+
+uint64_t piece_catalog_free_anchors(int piece_type, uint64_t occupied)
+{
+    const piece_info_t *info = piece_catalog_get(piece_type);
+    if (!info) return 0;
+
+    // an anchor is blocked if any of its cells lands on an occupied bit
+    const piece_shape_t *shape = info->shape;
+    uint64_t blocked = 0;
+    for (int i = 0; i < shape->num_cells; i++)
+    {
+        blocked |= occupied >> shape->offsets[i];
+    }
+    return shape->anchors & ~blocked;
+}
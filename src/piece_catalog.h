@@ -0,0 +1,50 @@
+#ifndef PIECE_CATALOG_H
+#define PIECE_CATALOG_H
+
+#include <stdint.h>
+
+// Most cells any piece can hold (the 4x4 definition box)
+#define PIECE_MAX_CELLS 16
+
+// Offset of one cell from the top-left of a trimmed shape
+typedef struct {
+    int8_t dx;
+    int8_t dy;
+} piece_cell_t;
+
+// A distinct piece shape, trimmed to its tight bounding box
+typedef struct {
+    int width;
+    int height;
+    int num_cells;
+    piece_cell_t cells[PIECE_MAX_CELLS];
+    uint8_t offsets[PIECE_MAX_CELLS];  // cells as bitboard offsets (dy * 8 + dx)
+    uint8_t row_cells[4];              // number of cells in each row of the box
+    uint8_t col_cells[4];              // number of cells in each column of the box
+    uint64_t mask;                     // cells packed at the top-left of a bitboard
+    uint64_t anchors;                  // legal top-left anchors on the 8x8 grid
+    int num_anchors;
+} piece_shape_t;
+
+// Catalog entry for one of the TETRIS_PIECES piece types
+typedef struct {
+    int canonical;  // lowest piece type with the same shape
+    int box_col;    // offset of the trimmed shape inside the 4x4 definition
+    int box_row;
+    const piece_shape_t *shape;
+} piece_info_t;
+
+// Build the catalog from the 4x4 piece definitions (idempotent)
+void piece_catalog_init(void);
+// Catalog entry for a piece type, or NULL if out of range
+const piece_info_t *piece_catalog_get(int piece_type);
+// Number of distinct shapes after collapsing duplicate piece types
+int piece_catalog_num_shapes(void);
+// Largest cell count over all shapes
+int piece_catalog_max_cells(void);
+// Bitboard of the piece's cells with its 4x4 box at (gx, gy); off-grid cells are dropped
+uint64_t piece_catalog_mask_at(int piece_type, int gx, int gy);
+// Legal anchors (trimmed-box top-left, see GRID_BIT) where the piece avoids occupied
+uint64_t piece_catalog_free_anchors(int piece_type, uint64_t occupied);
+
+#endif // PIECE_CATALOG_H
@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <stddef.h>
+#include "profiler.h"
+#include "input_latency.h"
+#include "font.h"
+#include "span.h"
+
+#define COLOR_BLACK 0x0000
+
+static const char *const section_names[PROF_SECTION_COUNT] = {
+    "GRID", "BLKS", "SIDE", "SCOR", "FOOT", "DUPD", "GOVR",
+};
+
+static uint32_t last_frame[PROF_SECTION_COUNT];
+static void (*frame_hook)(const uint32_t *us) = NULL;
+// Overlay page shown, 0 when hidden
+enum { OVERLAY_OFF, OVERLAY_TIMINGS, OVERLAY_LATENCY, OVERLAY_PAGES };
+static int overlay_page = OVERLAY_OFF;
+
+void profiler_end_frame(void)
+{
+    for (int i = 0; i < PROF_SECTION_COUNT; i++)
+    {
+        last_frame[i] = profiler_take_us((prof_section_t)i);
+    }
+    if (frame_hook) frame_hook(last_frame);
+}
+
+const uint32_t *profiler_last_frame(void)
+{
+    return last_frame;
+}
+
+const char *profiler_section_name(prof_section_t section)
+{
+    return section_names[section];
+}
+
+void profiler_set_frame_hook(void (*hook)(const uint32_t *us))
+{
+    frame_hook = hook;
+}
+
+void profiler_toggle_overlay(void)
+{
+    overlay_page = (overlay_page + 1) % OVERLAY_PAGES;
+}
+
+int profiler_overlay_visible(void)
+{
+    return overlay_page != OVERLAY_OFF;
+}
+
+// "NAME  12.34" in ms, without floating point
+static void draw_line(int row, const char *name, uint32_t us)
+{
+    char line[16];
+    snprintf(line, sizeof(line), "%-4s%3u.%02u", name, (unsigned)(us / 1000), (unsigned)(us % 1000 / 10));
+    font_draw_text(PROFILER_OVERLAY_X + 2, PROFILER_OVERLAY_Y + 2 + row * 10, line);
+}
+
+// Key count, then p50/p95/p99 and worst key-to-display time
+static void draw_latency(void)
+{
+    const latency_hist_t *hist = input_latency_hist();
+    char line[16];
+    snprintf(line, sizeof(line), "KEY%6lu", (unsigned long)hist->count);
+    font_draw_text(PROFILER_OVERLAY_X + 2, PROFILER_OVERLAY_Y + 2, line);
+    draw_line(1, "P50", (uint32_t)(latency_hist_quantile(hist, 0.50) / 1000));
+    draw_line(2, "P95", (uint32_t)(latency_hist_quantile(hist, 0.95) / 1000));
+    draw_line(3, "P99", (uint32_t)(latency_hist_quantile(hist, 0.99) / 1000));
+    draw_line(4, "MAX", (uint32_t)(hist->max / 1000));
+}
+
+void profiler_draw_overlay(void)
+{
+    if (overlay_page == OVERLAY_OFF) return;
+
+    span_rect(PROFILER_OVERLAY_X, PROFILER_OVERLAY_Y, PROFILER_OVERLAY_W, PROFILER_OVERLAY_H, COLOR_BLACK);
+    if (overlay_page == OVERLAY_LATENCY)
+    {
+        draw_latency();
+        return;
+    }
+
+    uint32_t total = 0;
+    for (int i = 0; i < PROF_SECTION_COUNT; i++)
+    {
+        draw_line(i, section_names[i], last_frame[i]);
+        total += last_frame[i];
+    }
+    draw_line(PROF_SECTION_COUNT, "ALL", total);
+}
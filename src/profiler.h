@@ -0,0 +1,61 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+// Per-frame timings of the drawing and game-over code, built only with the
+// PROFILER option (CMakeLists.txt). Sections are timed with libprof on the
+// add-in (profiler_prof.c) and with the monotonic clock on the host
+// (host/profiler_host.c); without PROFILER the hooks compile to nothing
+
+typedef enum {
+    PROF_GRID,      // background and grid cells
+    PROF_PLACED,    // grid_draw_placed_blocks
+    PROF_SIDEBAR,   // tetris_blocks_draw
+    PROF_SCORE,     // score_draw
+    PROF_FOOTER,    // renderer_draw_footer
+    PROF_DUPDATE,   // dupdate
+    PROF_GAME_OVER, // game-over check
+    PROF_SECTION_COUNT
+} prof_section_t;
+
+#ifdef PROFILER
+#define PROFILE_ENTER(section) profiler_enter(section)
+#define PROFILE_LEAVE(section) profiler_leave(section)
+#else
+#define PROFILE_ENTER(section) ((void)0)
+#define PROFILE_LEAVE(section) ((void)0)
+#endif
+
+// Clock backend
+void profiler_init(void);
+void profiler_enter(prof_section_t section);
+void profiler_leave(prof_section_t section);
+// Time spent in a section since the last call, in microseconds
+uint32_t profiler_take_us(prof_section_t section);
+// Stopwatch for spans that end in another call, e.g. a key and its frame
+typedef uint64_t profiler_stamp_t;
+profiler_stamp_t profiler_stamp(void);
+// Nanoseconds since the stamp was taken
+uint64_t profiler_since_ns(profiler_stamp_t stamp);
+
+// Close the frame: the time of every section since the last frame becomes
+// the last frame's timings, passed to the frame hook if one is set
+void profiler_end_frame(void);
+// Microseconds per section of the last frame
+const uint32_t *profiler_last_frame(void);
+const char *profiler_section_name(prof_section_t section);
+void profiler_set_frame_hook(void (*hook)(const uint32_t *us));
+
+// Overlay in the bottom-right corner of the screen; each toggle shows the
+// next page: the last frame's timings in ms, then the key-to-display
+// latency (input_latency.h), then nothing
+#define PROFILER_OVERLAY_X 288
+#define PROFILER_OVERLAY_Y 140
+#define PROFILER_OVERLAY_W 84
+#define PROFILER_OVERLAY_H ((PROF_SECTION_COUNT + 1) * 10 + 2)
+void profiler_toggle_overlay(void);
+int profiler_overlay_visible(void);
+void profiler_draw_overlay(void);
+
+#endif // PROFILER_H
@@ -0,0 +1,46 @@
+#include <libprof.h>
+#include "profiler.h"
+
+// One libprof context per section; they are never nested in themselves
+static prof_t sections[PROF_SECTION_COUNT];
+
+void profiler_init(void)
+{
+    prof_init();
+    for (int i = 0; i < PROF_SECTION_COUNT; i++) sections[i] = prof_make();
+}
+
+void profiler_enter(prof_section_t section)
+{
+    prof_enter(sections[section]);
+}
+
+void profiler_leave(prof_section_t section)
+{
+    prof_leave(sections[section]);
+}
+
+uint32_t profiler_take_us(prof_section_t section)
+{
+    uint32_t us = prof_time(sections[section]);
+    sections[section] = prof_make();
+    return us;
+}
+
+// A context entered once holds the timer count at that moment; leaving a
+// copy of it later gives the time since
+profiler_stamp_t profiler_stamp(void)
+{
+    prof_t prof = prof_make();
+    prof_enter(prof);
+    return prof.elapsed;
+}
+
+uint64_t profiler_since_ns(profiler_stamp_t stamp)
+{
+    prof_t prof = prof_make();
+    prof.rec = 1;
+    prof.elapsed = (uint32_t)stamp;
+    prof_leave(prof);
+    return (uint64_t)prof_time(prof) * 1000;
+}
@@ -1,10 +1,18 @@
 #include <gint/display.h>
+#include <gint/drivers/r61524.h>
 #include "renderer.h"
 #include <stdio.h>
 #include <string.h>
 #include "font.h"
 #include "grid.h"
 #include "tetris_blocks.h"
+#include "score.h"
+#include "piece_catalog.h"
+#include "tile_cache.h"
+#include "profiler.h"
+#include "input_latency.h"
+#include "blend.h"
+#include "background.h"
 
 // Screen dimensions
 #define SCREEN_WIDTH 396
@@ -36,17 +44,6 @@ void renderer_draw_game_over(void)
     renderer_draw_footer();
 }
 
-static inline uint16_t blend565(uint16_t a, uint16_t b, int t /*0..255*/)
-{
-    // Linear blend a*(255-t)/255 + b*t/255 in RGB565
-    int ar = (a >> 11) & 0x1F, ag = (a >> 5) & 0x3F, ab = a & 0x1F;
-    int br = (b >> 11) & 0x1F, bg = (b >> 5) & 0x3F, bb = b & 0x1F;
-    int rr = (ar * (255 - t) + br * t) / 255;
-    int rg = (ag * (255 - t) + bg * t) / 255;
-    int rb = (ab * (255 - t) + bb * t) / 255;
-    return (uint16_t)((rr << 11) | (rg << 5) | rb);
-}
-
 uint16_t renderer_blend565(uint16_t a, uint16_t b, int t)
 {
     return blend565(a, b, t);
@@ -59,78 +56,259 @@ void renderer_set_tile_color(uint16_t color)
     g_tile_base_color = color;
 }
 
-static void draw_bevel_tile_internal(int x, int y, int size, int is_selected)
+void renderer_draw_beveled_tile(int x, int y, int size, int is_selected)
 {
-    // Base color with darker shading
-    const uint16_t base = g_tile_base_color; // configurable base color
-    const uint16_t deep = blend565(base, COLOR_BLACK, 180); // darker red
+    tile_cache_draw(x, y, size, is_selected, g_tile_base_color);
+}
 
-    for (int py = 0; py < size; py++)
+void renderer_draw_filled_cell(int grid_x, int grid_y)
+{
+    int screen_x = GRID_X_OFFSET + grid_x * GRID_CELL_SIZE;
+    int screen_y = GRID_Y_OFFSET + grid_y * GRID_CELL_SIZE;
+    tile_cache_draw(screen_x, screen_y, GRID_CELL_SIZE, 0, g_tile_base_color);
+}
+
+// Sidebar: three piece previews of up to 4x4 blocks with a 1px gap
+#define SIDEBAR_X TETRIS_AREA_X
+#define SIDEBAR_Y TETRIS_AREA_Y
+#define SIDEBAR_W (4 * (TETRIS_BLOCK_SIZE + 1))
+#define SIDEBAR_H (2 * TETRIS_SPACING + 4 * (TETRIS_BLOCK_SIZE + 1))
+
+// Right panel: score lines and footer (see score_draw, renderer_draw_footer)
+#define PANEL_X (GRID_X_OFFSET + GRID_SIZE * GRID_CELL_SIZE + 10)
+#define PANEL_Y (GRID_Y_OFFSET + 10)
+#define PANEL_BOTTOM (GRID_Y_OFFSET + 20 + 46 + 3 * 12)
+
+// What a grid cell shows: locked tile color, or the active block's color
+// and tint. Active tiles cover the whole cell
+#define CELL_EMPTY 0u
+#define CELL_LOCKED (1u << 16)
+#define CELL_ACTIVE (2u << 16)
+#define CELL_OVERLAP (4u << 16)
+
+// Everything the game screen depends on; repainting is driven by comparing
+// the current state against the one last put on screen
+typedef struct {
+    uint32_t cells[GRID_SIZE * GRID_SIZE];
+    int pieces[3];
+    uint16_t piece_colors[3];
+    int selection;
+    int score;
+    int loaded_score;
+    int has_active;
+} frame_state_t;
+
+static frame_state_t shown;
+static int shown_valid = 0;
+// Above this many pixels a changed window is pushed with a full dupdate
+#define LCD_WINDOW_MAX_AREA (SCREEN_WIDTH * SCREEN_HEIGHT / 2)
+
+// Bounding box of the pixels repainted since the last present (x1, y1
+// exclusive); empty when x0 >= x1
+typedef struct {
+    int x0, y0, x1, y1;
+} screen_window_t;
+
+static screen_window_t damage;
+
+static void damage_add(int x, int y, int w, int h)
+{
+    if (damage.x0 >= damage.x1)
     {
-        for (int px = 0; px < size; px++)
-        {
-            // radialish gradient weight
-            int dx = (px - size / 2);
-            int dy = (py - size / 2);
-            int d2 = dx*dx + dy*dy;
-            int maxd2 = (size*size)/2;
-            if (maxd2 <= 0) maxd2 = 1;
-            int t = d2 * 255 / maxd2; if (t > 255) t = 255;
-            uint16_t col = blend565(base, deep, t/2);
-            dpixel(x + px, y + py, col);
-        }
+        damage = (screen_window_t){ x, y, x + w, y + h };
+        return;
     }
+    if (x < damage.x0) damage.x0 = x;
+    if (y < damage.y0) damage.y0 = y;
+    if (x + w > damage.x1) damage.x1 = x + w;
+    if (y + h > damage.y1) damage.y1 = y + h;
+}
+
+// Push the damaged window to the LCD, or the whole VRAM if it is large
+static void push_damage(void)
+{
+    int x0 = damage.x0 < 0 ? 0 : damage.x0;
+    int y0 = damage.y0 < 0 ? 0 : damage.y0;
+    int x1 = damage.x1 > SCREEN_WIDTH ? SCREEN_WIDTH : damage.x1;
+    int y1 = damage.y1 > SCREEN_HEIGHT ? SCREEN_HEIGHT : damage.y1;
+    damage = (screen_window_t){ 0, 0, 0, 0 };
 
-    // Bevel: light top-left, dark bottom-right
-    int rim = size / 6; if (rim < 2) rim = 2; if (rim > 4) rim = 4;
-    for (int i = 0; i < rim; i++)
+    if ((x1 - x0) * (y1 - y0) > LCD_WINDOW_MAX_AREA)
     {
-        uint16_t edgeLight = blend565(base, COLOR_WHITE, 160 - i*40);
-        uint16_t edgeDark = blend565(base, deep, 200);
-        // top
-        for (int px = i; px < size - i; px++) dpixel(x + px, y + i, edgeLight);
-        // left
-        for (int py = i; py < size - i; py++) dpixel(x + i, y + py, edgeLight);
-        // bottom
-        for (int px = i; px < size - i; px++) dpixel(x + px, y + size - 1 - i, edgeDark);
-        // right
-        for (int py = i; py < size - i; py++) dpixel(x + size - 1 - i, y + py, edgeDark);
+        dupdate();
     }
+    else if (x0 < x1 && y0 < y1)
+    {
+        // Inclusive bounds; the VRAM stays as it is, there is only one
+        r61524_display_rect(gint_vram, x0, x1 - 1, y0, y1 - 1);
+    }
+}
 
+// Particles are on screen and must be painted over on the next present
+static int overlay_shown = 0;
 
-    // Thin outer border for definition
-    for (int px = 0; px < size; px++) { dpixel(x + px, y, COLOR_BLACK); dpixel(x + px, y + size - 1, COLOR_BLACK); }
-    for (int py = 0; py < size; py++) { dpixel(x, y + py, COLOR_BLACK); dpixel(x + size - 1, y + py, COLOR_BLACK); }
+static void capture_frame_state(frame_state_t *f)
+{
+    uint64_t occupied = grid_get_occupancy();
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++)
+    {
+        f->cells[i] = (occupied >> i) & 1
+            ? CELL_LOCKED | grid_get_cell_color(i % GRID_SIZE, i / GRID_SIZE)
+            : CELL_EMPTY;
+    }
 
-    // selection outline (on top of black border)
-    if (is_selected)
+    const placed_block_t *active = grid_get_active_placed_block();
+    if (active)
     {
-        for (int px = 0; px < size; px++) { dpixel(x + px, y, COLOR_WHITE); dpixel(x + px, y + size - 1, COLOR_WHITE); }
-        for (int py = 0; py < size; py++) { dpixel(x, y + py, COLOR_WHITE); dpixel(x + size - 1, y + py, COLOR_WHITE); }
+        uint32_t key = CELL_ACTIVE | active->color;
+        if (grid_active_overlaps_existing()) key |= CELL_OVERLAP;
+        uint64_t m = piece_catalog_mask_at(active->piece_type, active->grid_x, active->grid_y);
+        for (int bit = 0; m; bit++, m >>= 1)
+        {
+            if (m & 1) f->cells[bit] = key;
+        }
     }
+
+    for (int i = 0; i < 3; i++)
+    {
+        f->pieces[i] = tetris_blocks_get_piece_type_for_selection(i);
+        f->piece_colors[i] = tetris_blocks_get_piece_color_for_slot(i);
+    }
+    f->selection = tetris_blocks_get_selection();
+    f->score = score_get_current();
+    f->loaded_score = score_get_loaded();
+    f->has_active = active != NULL;
 }
 
-void renderer_draw_beveled_tile(int x, int y, int size, int is_selected)
+static void draw_full_frame(void)
 {
-    draw_bevel_tile_internal(x, y, size, is_selected);
+    PROFILE_ENTER(PROF_GRID);
+    background_draw();
+    PROFILE_LEAVE(PROF_GRID);
+    PROFILE_ENTER(PROF_PLACED);
+    grid_draw_placed_blocks();
+    PROFILE_LEAVE(PROF_PLACED);
+    PROFILE_ENTER(PROF_SCORE);
+    grid_draw_score();
+    PROFILE_LEAVE(PROF_SCORE);
+    PROFILE_ENTER(PROF_SIDEBAR);
+    tetris_blocks_draw();
+    PROFILE_LEAVE(PROF_SIDEBAR);
+    PROFILE_ENTER(PROF_FOOTER);
+    renderer_draw_footer();
+    PROFILE_LEAVE(PROF_FOOTER);
 }
 
-void renderer_draw_filled_cell(int grid_x, int grid_y)
+void renderer_init(void)
 {
-    int screen_x = GRID_X_OFFSET + grid_x * GRID_CELL_SIZE;
-    int screen_y = GRID_Y_OFFSET + grid_y * GRID_CELL_SIZE;
-    draw_bevel_tile_internal(screen_x, screen_y, GRID_CELL_SIZE, 0);
+    // Draw into a single VRAM so partial repaints build on the last frame
+    // (with two buffers, dupdate would flip to a stale one)
+    uint16_t *main_vram, *secondary_vram;
+    dgetvram(&main_vram, &secondary_vram);
+    dsetvram(main_vram, main_vram);
+    shown_valid = 0;
+}
+
+void renderer_invalidate(void)
+{
+    shown_valid = 0;
+}
+
+int renderer_present(void)
+{
+    frame_state_t now;
+    capture_frame_state(&now);
+
+    // Particles move every tick and are not tracked per region: while they
+    // are up (or still on screen from the last frame) repaint everything
+    int overlay = grid_particles_active();
+    if (!shown_valid || overlay || overlay_shown)
+    {
+        draw_full_frame();
+        damage_add(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    }
+    else
+    {
+        int dirty = 0;
+
+        // Grid: only the cells whose content changed, e.g. the union of the
+        // active block's old and new cells after a move
+        PROFILE_ENTER(PROF_GRID);
+        for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++)
+        {
+            if (now.cells[i] == shown.cells[i]) continue;
+            grid_draw_cell(i % GRID_SIZE, i / GRID_SIZE);
+            damage_add(GRID_X_OFFSET + (i % GRID_SIZE) * GRID_CELL_SIZE,
+                       GRID_Y_OFFSET + (i / GRID_SIZE) * GRID_CELL_SIZE, GRID_CELL_SIZE, GRID_CELL_SIZE);
+            dirty = 1;
+        }
+        PROFILE_LEAVE(PROF_GRID);
+
+        if (memcmp(now.pieces, shown.pieces, sizeof(now.pieces)) ||
+            memcmp(now.piece_colors, shown.piece_colors, sizeof(now.piece_colors)) ||
+            now.selection != shown.selection)
+        {
+            PROFILE_ENTER(PROF_SIDEBAR);
+            background_restore(SIDEBAR_X, SIDEBAR_Y, SIDEBAR_W, SIDEBAR_H);
+            tetris_blocks_draw();
+            PROFILE_LEAVE(PROF_SIDEBAR);
+            damage_add(SIDEBAR_X, SIDEBAR_Y, SIDEBAR_W, SIDEBAR_H);
+            dirty = 1;
+        }
+
+        if (now.score != shown.score || now.loaded_score != shown.loaded_score ||
+            now.has_active != shown.has_active)
+        {
+            PROFILE_ENTER(PROF_SCORE);
+            background_restore(PANEL_X, PANEL_Y, SCREEN_WIDTH - PANEL_X, PANEL_BOTTOM - PANEL_Y);
+            grid_draw_score();
+            PROFILE_LEAVE(PROF_SCORE);
+            PROFILE_ENTER(PROF_FOOTER);
+            renderer_draw_footer();
+            PROFILE_LEAVE(PROF_FOOTER);
+            damage_add(PANEL_X, PANEL_Y, SCREEN_WIDTH - PANEL_X, PANEL_BOTTOM - PANEL_Y);
+            dirty = 1;
+        }
+
+        // Nothing changed: keep the frame on screen as it is, which already
+        // shows what the keys did
+        if (!dirty)
+        {
+            LATENCY_SHOWN();
+            return 0;
+        }
+    }
+
+    if (overlay) grid_draw_particles();
+    overlay_shown = overlay;
+
+#ifdef PROFILER
+    // The timings box has its own corner, repainted on every frame
+    if (profiler_overlay_visible())
+    {
+        background_restore(PROFILER_OVERLAY_X, PROFILER_OVERLAY_Y, PROFILER_OVERLAY_W, PROFILER_OVERLAY_H);
+        profiler_draw_overlay();
+        damage_add(PROFILER_OVERLAY_X, PROFILER_OVERLAY_Y, PROFILER_OVERLAY_W, PROFILER_OVERLAY_H);
+    }
+#endif
+
+    // Only the repainted window goes to the LCD, e.g. a few cells after a move
+    PROFILE_ENTER(PROF_DUPDATE);
+    push_damage();
+    PROFILE_LEAVE(PROF_DUPDATE);
+    LATENCY_SHOWN();
+#ifdef PROFILER
+    profiler_end_frame();
+#endif
+    shown = now;
+    shown_valid = 1;
+    return 1;
 }
 
 void renderer_redraw_all(void)
 {
-    dclear(COLOR_BACKGROUND);
-    grid_draw();
-    grid_draw_placed_blocks();
-    grid_draw_score();
-    tetris_blocks_draw();
-    renderer_draw_footer();
-    dupdate();
+    renderer_invalidate();
+    renderer_present();
 }
 
 void renderer_draw_footer(void)
@@ -145,10 +323,10 @@ void renderer_draw_footer(void)
     int x = GRID_X_OFFSET + GRID_SIZE * GRID_CELL_SIZE + 10;
     int y = GRID_Y_OFFSET + 20 + 46;
     int line_step = 12;
-    font_draw_text(x, y + 0 * line_step, line1);
-    font_draw_text(x, y + 1 * line_step, line2);
+    font_draw_text_cached(x, y + 0 * line_step, line1, COLOR_BACKGROUND);
+    font_draw_text_cached(x, y + 1 * line_step, line2, COLOR_BACKGROUND);
     if (line3[0] != '\0')
     {
-        font_draw_text(x, y + 2 * line_step, line3);
+        font_draw_text_cached(x, y + 2 * line_step, line3, COLOR_BACKGROUND);
     }
 }
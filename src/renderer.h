@@ -2,8 +2,18 @@
 #define RENDERER_H
 
 // Rendering functions
+// Set up the display; call once before drawing
+void renderer_init(void);
+// Repaint the parts of the game screen that changed since the last
+// present and push their bounding box to the LCD (all of it if large);
+// returns 0 without drawing or pushing anything if nothing changed
+int renderer_present(void);
+// Forget what is on screen (after drawing outside the renderer) so the
+// next present repaints everything
+void renderer_invalidate(void);
 void renderer_draw_game_over(void);
 void renderer_draw_filled_cell(int grid_x, int grid_y);
+// Repaint and push the whole game screen
 void renderer_redraw_all(void);
 void renderer_draw_beveled_tile(int x, int y, int size, int is_selected);
 void renderer_draw_footer(void);
@@ -0,0 +1,491 @@
+#include <string.h>
+#include "replay.h"
+#include "game_state.h"
+#include "grid.h"
+#include "score.h"
+
+static const uint8_t magic[3] = { 'B', 'B', 'R' };
+static const uint8_t trailer_magic[4] = { 'B', 'B', 'R', 'X' };
+
+// Unsigned LEB128: 7 bits per byte, low bits first, high bit set on all
+// but the last byte
+static int put_varint(uint8_t *out, uint32_t value)
+{
+    int n = 0;
+    while (value >= 0x80)
+    {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+static int get_varint(const uint8_t *in, uint32_t len, uint32_t *pos, uint32_t *value)
+{
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35 && *pos < len; shift += 7)
+    {
+        uint8_t b = in[(*pos)++];
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+        {
+            *value = v;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int read_varint(FILE *fp, uint32_t *value)
+{
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        int b = fgetc(fp);
+        if (b == EOF) return 0;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+        {
+            *value = v;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Fixed-width fields, little endian whatever the CPU (the SH4 is big endian)
+static uint8_t *put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v)
+{
+    p = put_u16(p, (uint16_t)v);
+    return put_u16(p, (uint16_t)(v >> 16));
+}
+
+static const uint8_t *get_u16(const uint8_t *p, uint16_t *v)
+{
+    *v = (uint16_t)(p[0] | p[1] << 8);
+    return p + 2;
+}
+
+static const uint8_t *get_u32(const uint8_t *p, uint32_t *v)
+{
+    uint16_t lo, hi;
+    p = get_u16(p, &lo);
+    p = get_u16(p, &hi);
+    *v = (uint32_t)lo | (uint32_t)hi << 16;
+    return p;
+}
+
+void replay_init(replay_t *replay, uint32_t seed)
+{
+    replay->seed = seed;
+    replay->score = 0;
+    replay->num_actions = 0;
+    replay->length = 0;
+    replay->num_turns = 0;
+    replay->num_keyframes = 0;
+}
+
+int replay_is_game_action(input_action_t action)
+{
+    switch (action)
+    {
+        case INPUT_ACTION_EXIT:
+        case INPUT_ACTION_PLACE_BLOCK:
+        case INPUT_ACTION_MOVE_UP:
+        case INPUT_ACTION_MOVE_DOWN:
+        case INPUT_ACTION_MOVE_LEFT:
+        case INPUT_ACTION_MOVE_RIGHT:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+int replay_append(replay_t *replay, input_action_t action)
+{
+    uint8_t buf[5];
+    int n = put_varint(buf, (uint32_t)action);
+    if (replay->length + n > REPLAY_MAX_BYTES) return 0;
+    memcpy(replay->data + replay->length, buf, n);
+    replay->length += n;
+    replay->num_actions++;
+    return 1;
+}
+
+int replay_next_action(const replay_t *replay, uint32_t *pos)
+{
+    uint32_t value;
+    if (!get_varint(replay->data, replay->length, pos, &value)) return -1;
+    return (int)value;
+}
+
+// --- Keyframes ---
+
+void replay_keyframe_take(replay_keyframe_t *keyframe, const game_ctx_t *ctx)
+{
+    keyframe->occupied = ctx->grid.occupied;
+    memcpy(keyframe->color, ctx->grid.color, sizeof(keyframe->color));
+    for (int i = 0; i < 3; i++)
+    {
+        keyframe->stored_pieces[i] = (int8_t)ctx->blocks.stored_pieces[i];
+        keyframe->stored_piece_colors[i] = ctx->blocks.stored_piece_colors[i];
+    }
+    keyframe->selected_block = (uint8_t)ctx->blocks.selected_block;
+    keyframe->game_over = (uint8_t)ctx->game_over;
+    keyframe->score = (uint32_t)ctx->score.current;
+    memcpy(keyframe->rng, ctx->rng, sizeof(keyframe->rng));
+}
+
+void replay_keyframe_restore(game_ctx_t *ctx, const replay_keyframe_t *keyframe)
+{
+    grid_init_ctx(ctx);
+
+    grid_state_t *g = &ctx->grid;
+    g->occupied = keyframe->occupied;
+    for (int i = 0; i < GRID_SIZE; i++)
+    {
+        g->row_fill[i] = (uint8_t)__builtin_popcountll(g->occupied & (GRID_ROW_MASK << (i * GRID_SIZE)));
+        g->col_fill[i] = (uint8_t)__builtin_popcountll(g->occupied & (GRID_COL_MASK << i));
+    }
+    memcpy(g->color, keyframe->color, sizeof(g->color));
+
+    for (int i = 0; i < 3; i++)
+    {
+        ctx->blocks.stored_pieces[i] = keyframe->stored_pieces[i];
+        ctx->blocks.stored_piece_colors[i] = keyframe->stored_piece_colors[i];
+    }
+    ctx->blocks.selected_block = keyframe->selected_block;
+    ctx->game_over = keyframe->game_over;
+    ctx->score.current = (int)keyframe->score;
+    memcpy(ctx->rng, keyframe->rng, sizeof(ctx->rng));
+}
+
+static void encode_keyframe(uint8_t *p, const replay_keyframe_t *keyframe)
+{
+    p = put_u32(p, keyframe->turn);
+    p = put_u32(p, keyframe->actions);
+    p = put_u32(p, keyframe->offset);
+    p = put_u32(p, (uint32_t)keyframe->occupied);
+    p = put_u32(p, (uint32_t)(keyframe->occupied >> 32));
+    for (int y = 0; y < GRID_SIZE; y++)
+    {
+        for (int x = 0; x < GRID_SIZE; x++) p = put_u16(p, keyframe->color[y][x]);
+    }
+    for (int i = 0; i < 3; i++) *p++ = (uint8_t)keyframe->stored_pieces[i];
+    for (int i = 0; i < 3; i++) p = put_u16(p, keyframe->stored_piece_colors[i]);
+    *p++ = keyframe->selected_block;
+    *p++ = keyframe->game_over;
+    p = put_u32(p, keyframe->score);
+    for (int s = 0; s < RNG_STREAM_COUNT; s++)
+    {
+        for (int i = 0; i < 4; i++) p = put_u32(p, keyframe->rng[s].s[i]);
+    }
+}
+
+static void decode_keyframe(const uint8_t *p, replay_keyframe_t *keyframe)
+{
+    uint32_t lo, hi;
+    p = get_u32(p, &keyframe->turn);
+    p = get_u32(p, &keyframe->actions);
+    p = get_u32(p, &keyframe->offset);
+    p = get_u32(p, &lo);
+    p = get_u32(p, &hi);
+    keyframe->occupied = (uint64_t)hi << 32 | lo;
+    for (int y = 0; y < GRID_SIZE; y++)
+    {
+        for (int x = 0; x < GRID_SIZE; x++) p = get_u16(p, &keyframe->color[y][x]);
+    }
+    for (int i = 0; i < 3; i++) keyframe->stored_pieces[i] = (int8_t)*p++;
+    for (int i = 0; i < 3; i++) p = get_u16(p, &keyframe->stored_piece_colors[i]);
+    keyframe->selected_block = *p++;
+    keyframe->game_over = *p++;
+    p = get_u32(p, &keyframe->score);
+    for (int s = 0; s < RNG_STREAM_COUNT; s++)
+    {
+        for (int i = 0; i < 4; i++) p = get_u32(p, &keyframe->rng[s].s[i]);
+    }
+}
+
+// --- Files ---
+
+int replay_write(FILE *fp, const replay_t *replay)
+{
+    uint8_t header[4 + 7 * 5];
+    int n = 0;
+    memcpy(header, magic, sizeof(magic));
+    n += sizeof(magic);
+    header[n++] = REPLAY_VERSION;
+    n += put_varint(header + n, replay->seed);
+    n += put_varint(header + n, replay->score);
+    n += put_varint(header + n, replay->num_actions);
+    n += put_varint(header + n, replay->length);
+    n += put_varint(header + n, replay->num_turns);
+    n += put_varint(header + n, replay->num_keyframes);
+    n += put_varint(header + n, REPLAY_KEYFRAME_INTERVAL);
+    if (fwrite(header, 1, n, fp) != (size_t)n) return 0;
+    if (fwrite(replay->data, 1, replay->length, fp) != replay->length) return 0;
+
+    uint32_t keyframes = (uint32_t)n + replay->length;
+    uint8_t buf[REPLAY_KEYFRAME_BYTES];
+    for (uint32_t k = 0; k < replay->num_keyframes; k++)
+    {
+        encode_keyframe(buf, &replay->keyframes[k]);
+        if (fwrite(buf, 1, sizeof(buf), fp) != sizeof(buf)) return 0;
+    }
+
+    uint32_t index = keyframes + replay->num_keyframes * REPLAY_KEYFRAME_BYTES;
+    for (uint32_t k = 0; k < replay->num_keyframes; k++)
+    {
+        put_u32(put_u32(buf, replay->keyframes[k].turn), keyframes + k * REPLAY_KEYFRAME_BYTES);
+        if (fwrite(buf, 1, 8, fp) != 8) return 0;
+    }
+    put_u32(buf, index);
+    memcpy(buf + 4, trailer_magic, sizeof(trailer_magic));
+    return fwrite(buf, 1, 8, fp) == 8;
+}
+
+// Header fields of the record at the current position, which ends up at
+// the start of its actions
+static int read_header(FILE *fp, replay_info_t *info)
+{
+    uint8_t head[4];
+    info->start = ftell(fp);
+    size_t got = fread(head, 1, sizeof(head), fp);
+    if (got == 0) return 0;
+    if (got != sizeof(head) || memcmp(head, magic, sizeof(magic))) return -1;
+    info->version = head[3];
+    if (info->version != 1 && info->version != 2) return -1;
+
+    if (!read_varint(fp, &info->seed) || !read_varint(fp, &info->score) ||
+        !read_varint(fp, &info->num_actions) || !read_varint(fp, &info->length))
+    {
+        return -1;
+    }
+    info->num_turns = 0;
+    info->num_keyframes = 0;
+    info->interval = 0;
+    if (info->version >= 2 &&
+        (!read_varint(fp, &info->num_turns) || !read_varint(fp, &info->num_keyframes) ||
+         !read_varint(fp, &info->interval)))
+    {
+        return -1;
+    }
+    if (info->length > REPLAY_MAX_BYTES) return -1;
+
+    info->actions = ftell(fp);
+    info->end = info->actions + (long)info->length;
+    if (info->version >= 2) info->end += (long)info->num_keyframes * (REPLAY_KEYFRAME_BYTES + 8) + 8;
+    return 1;
+}
+
+int replay_read_info(FILE *fp, replay_info_t *info)
+{
+    int status = read_header(fp, info);
+    if (status <= 0) return status;
+    if (fseek(fp, info->end, SEEK_SET)) return -1;
+    return 1;
+}
+
+int replay_read(FILE *fp, replay_t *replay)
+{
+    replay_info_t info;
+    int status = read_header(fp, &info);
+    if (status <= 0) return status;
+
+    replay->seed = info.seed;
+    replay->score = info.score;
+    replay->num_actions = info.num_actions;
+    replay->length = info.length;
+    replay->num_turns = info.num_turns;
+    replay->num_keyframes = 0;
+    if (fread(replay->data, 1, info.length, fp) != info.length) return -1;
+
+    uint8_t buf[REPLAY_KEYFRAME_BYTES];
+    for (uint32_t k = 0; k < info.num_keyframes; k++)
+    {
+        if (fread(buf, 1, sizeof(buf), fp) != sizeof(buf)) return -1;
+        if (k < REPLAY_MAX_KEYFRAMES) decode_keyframe(buf, &replay->keyframes[replay->num_keyframes++]);
+    }
+    // Index and trailer: only needed to seek
+    if (fseek(fp, info.end, SEEK_SET)) return -1;
+    return 1;
+}
+
+int replay_seek(FILE *fp, const replay_info_t *info, uint32_t turn, game_ctx_t *ctx)
+{
+    if (info->version >= 2 && turn > info->num_turns) turn = info->num_turns;
+
+    // Last keyframe at or before the turn, found through the index
+    uint32_t reached = 0, offset = 0;
+    int k = info->interval ? (int)(turn / info->interval) - 1 : -1;
+    if (k >= (int)info->num_keyframes) k = (int)info->num_keyframes - 1;
+    if (k >= 0)
+    {
+        uint8_t buf[REPLAY_KEYFRAME_BYTES];
+        uint32_t index, entry_turn, keyframe_offset;
+        if (fseek(fp, info->end - 8, SEEK_SET) || fread(buf, 1, 8, fp) != 8 ||
+            memcmp(buf + 4, trailer_magic, sizeof(trailer_magic)))
+        {
+            return -1;
+        }
+        get_u32(buf, &index);
+        if (fseek(fp, info->start + (long)index + k * 8L, SEEK_SET) || fread(buf, 1, 8, fp) != 8) return -1;
+        get_u32(get_u32(buf, &entry_turn), &keyframe_offset);
+        // Keyframe k is taken at the end of turn (k + 1) * interval
+        if (entry_turn != (uint32_t)(k + 1) * info->interval) return -1;
+        if (fseek(fp, info->start + (long)keyframe_offset, SEEK_SET) ||
+            fread(buf, 1, sizeof(buf), fp) != sizeof(buf))
+        {
+            return -1;
+        }
+        replay_keyframe_t keyframe;
+        decode_keyframe(buf, &keyframe);
+        if (keyframe.turn != entry_turn) return -1;
+        replay_keyframe_restore(ctx, &keyframe);
+        reached = keyframe.turn;
+        offset = keyframe.offset;
+    }
+    else
+    {
+        game_ctx_init(ctx, info->seed);
+    }
+
+    // Then the actions up to the turn, a chunk at a time: fewer than
+    // REPLAY_KEYFRAME_INTERVAL turns' worth, one read in practice
+    if (fseek(fp, info->actions + (long)offset, SEEK_SET)) return -1;
+    uint8_t chunk[256];
+    uint32_t len = 0, pos = 0;
+    while (reached < turn && offset < info->length)
+    {
+        if (pos == len || (len - pos < 5 && offset + (len - pos) < info->length))
+        {
+            // Refill, keeping a partial varint
+            memmove(chunk, chunk + pos, len - pos);
+            len -= pos;
+            pos = 0;
+            uint32_t want = sizeof(chunk) - len;
+            uint32_t left = info->length - offset - len;
+            if (want > left) want = left;
+            if (fread(chunk + len, 1, want, fp) != want) return -1;
+            len += want;
+        }
+        uint32_t start = pos, action;
+        if (!get_varint(chunk, len, &pos, &action)) return -1;
+        offset += pos - start;
+        reached += (uint32_t)replay_apply_ctx(ctx, (input_action_t)action);
+    }
+    return (int)reached;
+}
+
+// --- Playback ---
+
+int replay_apply_ctx(game_ctx_t *ctx, input_action_t action)
+{
+    switch (action)
+    {
+        case INPUT_ACTION_EXIT:
+            game_state_cancel_active_ctx(ctx);
+            break;
+
+        case INPUT_ACTION_PLACE_BLOCK:
+            if (grid_get_active_block_ctx(ctx) != -1)
+            {
+                // The turn ends where the add-in's sweep would
+                if (game_state_place_active_ctx(ctx) >= 0)
+                {
+                    game_state_finish_turn_ctx(ctx);
+                    game_state_check_game_over_ctx(ctx);
+                    return 1;
+                }
+            }
+            else if (game_state_pick_selected_ctx(ctx))
+            {
+                game_state_check_game_over_ctx(ctx);
+            }
+            break;
+
+        case INPUT_ACTION_MOVE_UP:
+            game_state_move_ctx(ctx, 0, -1);
+            break;
+
+        case INPUT_ACTION_MOVE_DOWN:
+            game_state_move_ctx(ctx, 0, 1);
+            break;
+
+        case INPUT_ACTION_MOVE_LEFT:
+            game_state_move_ctx(ctx, -1, 0);
+            break;
+
+        case INPUT_ACTION_MOVE_RIGHT:
+            game_state_move_ctx(ctx, 1, 0);
+            break;
+
+        default:
+            break;
+    }
+    return 0;
+}
+
+uint32_t replay_play_ctx(game_ctx_t *ctx, const replay_t *replay)
+{
+    game_ctx_init(ctx, replay->seed);
+    uint32_t pos = 0;
+    int action;
+    while ((action = replay_next_action(replay, &pos)) >= 0)
+    {
+        replay_apply_ctx(ctx, (input_action_t)action);
+    }
+    return (uint32_t)score_get_current_ctx(ctx);
+}
+
+// --- Recording ---
+
+static replay_t recording;
+static int recording_active = 0;
+
+void replay_record_start(uint32_t seed)
+{
+    replay_init(&recording, seed);
+    recording_active = 1;
+}
+
+void replay_record_action(input_action_t action)
+{
+    if (!recording_active || !replay_is_game_action(action)) return;
+    // A game too long to record is dropped rather than saved cut short
+    if (!replay_append(&recording, action)) recording_active = 0;
+}
+
+void replay_record_turn(void)
+{
+    if (!recording_active) return;
+    recording.num_turns++;
+    if (recording.num_turns % REPLAY_KEYFRAME_INTERVAL || recording.num_keyframes == REPLAY_MAX_KEYFRAMES) return;
+
+    replay_keyframe_t *keyframe = &recording.keyframes[recording.num_keyframes++];
+    replay_keyframe_take(keyframe, game_ctx_default());
+    keyframe->turn = recording.num_turns;
+    keyframe->actions = recording.num_actions;
+    keyframe->offset = recording.length;
+}
+
+int replay_record_save(const char *path, uint32_t score)
+{
+    if (!recording_active) return 0;
+    recording_active = 0;
+    recording.score = score;
+
+    FILE *fp = fopen(path, "ab");
+    if (!fp) return 0;
+    int ok = replay_write(fp, &recording);
+    if (fclose(fp)) ok = 0;
+    return ok;
+}
@@ -0,0 +1,121 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "game_ctx.h"
+#include "input_action.h"
+
+// Game recordings: the seed of a game plus every action applied to it, one
+// LEB128 varint per action (a byte each today), with a full-state keyframe
+// every REPLAY_KEYFRAME_INTERVAL turns so a viewer can jump to any turn.
+// The add-in appends one record per game to REPLAY_PATH; blockblast-replay
+// plays them back on the host and checks the final score. A record is
+//   "BBR" version, then varints seed, score, action count, action bytes,
+//   turns, keyframe count, keyframe interval
+//   the actions
+//   the keyframes, REPLAY_KEYFRAME_BYTES each
+//   the index: per keyframe, its turn and offset (u32 each)
+//   the index offset (u32) and "BBRX"
+// with offsets from the start of the record and u32 in little endian.
+// Version 1 records (no keyframes, index or trailer) are still read
+
+#define REPLAY_PATH "/replays.bbr"
+#define REPLAY_VERSION 2
+// The game being recorded is held in RAM until it is saved: with about 8
+// action bytes per turn, the limits below cover games of some 500 turns for
+// about 11 KB of static RAM (REPLAY_MAX_BYTES plus 216 bytes per keyframe)
+// Encoded actions of one game; longer games are not recorded
+#define REPLAY_MAX_BYTES 4096
+#define REPLAY_KEYFRAME_INTERVAL 16
+// Keyframes of one game; later turns are reached from the last one
+#define REPLAY_MAX_KEYFRAMES 32
+#define REPLAY_KEYFRAME_BYTES 211
+
+// Game state at the end of a turn, when no block is active and the clear
+// sweep is over: all the game context holds then
+typedef struct {
+    uint32_t turn;              // turns played
+    uint32_t actions;           // actions applied
+    uint32_t offset;            // of the next action in the action bytes
+    uint64_t occupied;
+    uint16_t color[GRID_SIZE][GRID_SIZE];
+    int8_t stored_pieces[3];
+    uint16_t stored_piece_colors[3];
+    uint8_t selected_block;
+    uint8_t game_over;
+    uint32_t score;
+    rng_t rng[RNG_STREAM_COUNT];
+} replay_keyframe_t;
+
+typedef struct {
+    uint32_t seed;
+    uint32_t score;             // final score
+    uint32_t num_actions;
+    uint32_t length;            // bytes used in data
+    uint32_t num_turns;
+    uint32_t num_keyframes;
+    uint8_t data[REPLAY_MAX_BYTES];
+    replay_keyframe_t keyframes[REPLAY_MAX_KEYFRAMES];
+} replay_t;
+
+// Where a record is in its file, read from its header alone
+typedef struct {
+    long start;
+    long end;                   // just past the record
+    long actions;               // file offset of the action bytes
+    uint32_t version;
+    uint32_t seed;
+    uint32_t score;
+    uint32_t num_actions;
+    uint32_t length;
+    uint32_t num_turns;
+    uint32_t num_keyframes;
+    uint32_t interval;
+} replay_info_t;
+
+void replay_init(replay_t *replay, uint32_t seed);
+// Whether an action changes the game and so belongs in a recording
+int replay_is_game_action(input_action_t action);
+// Append an action; returns 0 if the record is full
+int replay_append(replay_t *replay, input_action_t action);
+// Decode the action at *pos and advance past it; returns -1 at the end
+int replay_next_action(const replay_t *replay, uint32_t *pos);
+
+void replay_keyframe_take(replay_keyframe_t *keyframe, const game_ctx_t *ctx);
+// Put ctx in the keyframe's state; the loaded score is kept
+void replay_keyframe_restore(game_ctx_t *ctx, const replay_keyframe_t *keyframe);
+
+// Returns 0 on a write error
+int replay_write(FILE *fp, const replay_t *replay);
+// Read the next record: 1 if read, 0 at the end of the file, -1 if the
+// file is not a replay or is truncated
+int replay_read(FILE *fp, replay_t *replay);
+// Read the header of the next record and skip to the one after; same
+// return values as replay_read
+int replay_read_info(FILE *fp, replay_info_t *info);
+// Put ctx in the state of the recorded game after `turn` turns (its last
+// turn if it has fewer) with a constant number of reads: the index entry
+// and keyframe before the turn, then the actions from there. Returns the
+// turn reached, or -1 on a read error
+int replay_seek(FILE *fp, const replay_info_t *info, uint32_t turn, game_ctx_t *ctx);
+
+// Apply an action the way input_process_action() does, with the line clear
+// sweep finished at once (every later key would cut it short anyway).
+// Returns 1 if the action ended a turn
+int replay_apply_ctx(game_ctx_t *ctx, input_action_t action);
+// Start the recorded game on ctx and apply all its actions; returns the
+// final score
+uint32_t replay_play_ctx(game_ctx_t *ctx, const replay_t *replay);
+
+// Recording of the game being played on game_ctx_default()
+void replay_record_start(uint32_t seed);
+void replay_record_action(input_action_t action);
+// A turn has ended (its clear sweep included): every
+// REPLAY_KEYFRAME_INTERVAL turns this takes a keyframe
+void replay_record_turn(void);
+// Append the recording with its final score to path and stop recording;
+// returns 0 if there was nothing to write or the write failed
+int replay_record_save(const char *path, uint32_t score);
+
+#endif // REPLAY_H
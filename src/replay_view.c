@@ -0,0 +1,101 @@
+#include <gint/display.h>
+#include <gint/keyboard.h>
+#include <stdio.h>
+#include "replay_view.h"
+#include "replay.h"
+#include "renderer.h"
+#include "grid.h"
+#include "font.h"
+
+// Most recent games listed; older ones are not shown
+#define REPLAY_VIEW_MAX_GAMES 128
+
+// Ring of the last headers read: game n of the file is at n % MAX
+static replay_info_t games[REPLAY_VIEW_MAX_GAMES];
+static game_ctx_t saved;
+
+// Number of games in the file; the last REPLAY_VIEW_MAX_GAMES of them are
+// kept in games
+static int list_games(FILE *fp)
+{
+    int total = 0;
+    while (replay_read_info(fp, &games[total % REPLAY_VIEW_MAX_GAMES]) == 1) total++;
+    return total;
+}
+
+static void draw_banner(const char *line1, const char *line2)
+{
+    int x = GRID_X_OFFSET + GRID_SIZE * GRID_CELL_SIZE + 10;
+    int y = GRID_Y_OFFSET + 20 + 46;
+    drect(x, y, DWIDTH - 1, y + 3 * 12 - 1, COLOR_BACKGROUND);
+    font_draw_text(x, y, line1);
+    font_draw_text(x, y + 12, line2);
+    dupdate();
+}
+
+void replay_view_run(void)
+{
+    game_ctx_t *ctx = game_ctx_default();
+    saved = *ctx;
+
+    FILE *fp = fopen(REPLAY_PATH, "rb");
+    int count = fp ? list_games(fp) : 0;
+    int first = count > REPLAY_VIEW_MAX_GAMES ? count - REPLAY_VIEW_MAX_GAMES : 0;
+    int game = count - 1;
+    int turn = 0;
+
+    while (1)
+    {
+        char line1[32], line2[32];
+        if (count > 0)
+        {
+            const replay_info_t *info = &games[game % REPLAY_VIEW_MAX_GAMES];
+            int reached = replay_seek(fp, info, (uint32_t)turn, ctx);
+            if (reached >= 0) turn = reached;
+            snprintf(line1, sizeof(line1), "GAME %d/%d", game + 1, count);
+            snprintf(line2, sizeof(line2), "TURN %d/%u", turn, (unsigned)info->num_turns);
+            if (reached < 0) snprintf(line2, sizeof(line2), "READ ERROR");
+        }
+        else
+        {
+            snprintf(line1, sizeof(line1), "NO REPLAYS");
+            line2[0] = '\0';
+        }
+        renderer_redraw_all();
+        draw_banner(line1, line2);
+
+        key_event_t key = getkey();
+        if (key.key == KEY_EXIT || key.key == KEY_MENU) break;
+        if (count == 0) continue;
+
+        switch (key.key)
+        {
+            case KEY_UP:
+                if (game > first) game--;
+                turn = 0;
+                break;
+            case KEY_DOWN:
+                if (game < count - 1) game++;
+                turn = 0;
+                break;
+            case KEY_LEFT:
+                if (turn > 0) turn--;
+                break;
+            case KEY_RIGHT:
+                turn++;
+                break;
+            case KEY_F1:
+                turn = turn > REPLAY_KEYFRAME_INTERVAL ? turn - REPLAY_KEYFRAME_INTERVAL : 0;
+                break;
+            case KEY_F2:
+                turn += REPLAY_KEYFRAME_INTERVAL;
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (fp) fclose(fp);
+    *ctx = saved;
+    renderer_invalidate();
+}
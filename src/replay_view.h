@@ -0,0 +1,11 @@
+#ifndef REPLAY_VIEW_H
+#define REPLAY_VIEW_H
+
+// Browse the most recent games saved in REPLAY_PATH, starting from the
+// newest, turn by turn, each shown with replay_seek() from its nearest
+// keyframe: UP/DOWN change game, LEFT/RIGHT step a turn, F1/F2 jump
+// REPLAY_KEYFRAME_INTERVAL turns, EXIT goes back to the game in play, left
+// as it was
+void replay_view_run(void);
+
+#endif // REPLAY_VIEW_H
@@ -0,0 +1,88 @@
+#include "rng.h"
+
+static uint32_t rotl(uint32_t x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+// splitmix32: consecutive outputs differ, so at most one of the four state
+// words can be zero
+static uint32_t splitmix32(uint32_t *x)
+{
+    uint32_t z = (*x += 0x9E3779B9u);
+    z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+    return z ^ (z >> 16);
+}
+
+void rng_seed(rng_t *rng, uint32_t seed)
+{
+    for (int i = 0; i < 4; i++) rng->s[i] = splitmix32(&seed);
+}
+
+void rng_seed_streams(rng_t streams[RNG_STREAM_COUNT], uint32_t seed)
+{
+    rng_t root;
+    rng_seed(&root, seed);
+    rng_seed_streams_from(streams, &root);
+}
+
+void rng_seed_streams_from(rng_t streams[RNG_STREAM_COUNT], const rng_t *root)
+{
+    streams[0] = *root;
+    for (int i = 1; i < RNG_STREAM_COUNT; i++)
+    {
+        streams[i] = streams[i - 1];
+        rng_jump(&streams[i]);
+    }
+}
+
+uint32_t rng_next(rng_t *rng)
+{
+    uint32_t *s = rng->s;
+    uint32_t result = rotl(s[1] * 5, 7) * 9;
+    uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 11);
+    return result;
+}
+
+uint32_t rng_below(rng_t *rng, uint32_t bound)
+{
+    return (uint32_t)(((uint64_t)rng_next(rng) * bound) >> 32);
+}
+
+int rng_range(rng_t *rng, int min, int max)
+{
+    if (max <= min) return min;
+    return min + (int)rng_below(rng, (uint32_t)(max - min) + 1);
+}
+
+// Jump polynomial x^(2^64) modulo the generator's
+// characteristic polynomial, as in the reference implementation
+static void jump_by(rng_t *rng, const uint32_t poly[4])
+{
+    uint32_t acc[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 4; i++)
+    {
+        for (int b = 0; b < 32; b++)
+        {
+            if (poly[i] & (1u << b))
+            {
+                for (int k = 0; k < 4; k++) acc[k] ^= rng->s[k];
+            }
+            rng_next(rng);
+        }
+    }
+    for (int k = 0; k < 4; k++) rng->s[k] = acc[k];
+}
+
+void rng_jump(rng_t *rng)
+{
+    static const uint32_t poly[4] = { 0x8764000Bu, 0xF542D2D3u, 0x6FA035C3u, 0x77F2DB5Bu };
+    jump_by(rng, poly);
+}
@@ -0,0 +1,38 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// xoshiro128** generator: 32-bit operations only, period 2^128 - 1. A game
+// draws from one stream per use, all derived from its seed, so the pieces
+// dealt do not depend on how many colors or particles were drawn before
+
+typedef struct {
+    uint32_t s[4];
+} rng_t;
+
+typedef enum {
+    RNG_STREAM_PIECES,  // weighted piece choice (tetris_blocks.c)
+    RNG_STREAM_COLORS,  // sidebar piece colors
+    RNG_STREAM_EFFECTS, // line clear particles (grid_draw.c)
+    RNG_STREAM_COUNT
+} rng_stream_t;
+
+// Expand a 32-bit seed into a (never all-zero) state
+void rng_seed(rng_t *rng, uint32_t seed);
+// Seed stream 0 and start every following stream 2^64 draws further, so
+// they never overlap
+void rng_seed_streams(rng_t streams[RNG_STREAM_COUNT], uint32_t seed);
+// The same from a full (not all-zero) 128-bit state as stream 0, for host
+// batches too large for 32-bit seeds to stay distinct
+void rng_seed_streams_from(rng_t streams[RNG_STREAM_COUNT], const rng_t *root);
+uint32_t rng_next(rng_t *rng);
+// Uniform in [0, bound), by multiply-shift (bias below 2^-32 * bound)
+uint32_t rng_below(rng_t *rng, uint32_t bound);
+// Uniform in [min, max]
+int rng_range(rng_t *rng, int min, int max);
+
+// Advance by 2^64 draws: 2^64 non-overlapping streams per seed
+void rng_jump(rng_t *rng);
+
+#endif // RNG_H
@@ -1,6 +1,8 @@
 #ifndef SCORE_H
 #define SCORE_H
 
+#include "game_ctx.h"
+
 // Scoring system
 #define SCORE_PIECE_PLACEMENT 5
 #define SCORE_LINE_CLEAR_1 20
@@ -8,15 +10,25 @@
 #define SCORE_LINE_CLEAR_3 80
 #define SCORE_LINE_CLEAR_4_PLUS 140
 
-// Score management
+// Score management on an explicit context (score.c)
+void score_init_ctx(game_ctx_t *ctx);
+int score_get_current_ctx(const game_ctx_t *ctx);
+void score_add_placement_ctx(game_ctx_t *ctx);
+void score_add_points_ctx(game_ctx_t *ctx, int points);
+void score_clear_lines(void);
+// Display helper for showing a score loaded from file under current score
+void score_set_loaded_ctx(game_ctx_t *ctx, int value);
+int score_get_loaded_ctx(const game_ctx_t *ctx);
+
+// The same on game_ctx_default() (game_compat.c)
 void score_init(void);
 int score_get_current(void);
 void score_add_placement(void);
 void score_add_points(int points);
-void score_clear_lines(void);
-void score_draw(void);
-// Display helper for showing a score loaded from file under current score
 void score_set_loaded(int value);
 int score_get_loaded(void);
 
+// Drawing (score_draw.c, add-in only)
+void score_draw(void);
+
 #endif // SCORE_H
@@ -0,0 +1,77 @@
+#include <gint/display.h>
+#include <string.h>
+#include "span.h"
+
+// Two pixels stored as one word
+typedef uint32_t __attribute__((may_alias)) pixel_pair_t;
+
+// Clip [x, x + w) to the screen; returns the visible width and moves *x
+static int clip_span(int *x, int w)
+{
+    if (*x < 0)
+    {
+        w += *x;
+        *x = 0;
+    }
+    if (*x + w > DWIDTH) w = DWIDTH - *x;
+    return w;
+}
+
+// Fill an unclipped span
+static void fill_row(uint16_t *dst, int w, uint16_t color)
+{
+    if (w > 0 && ((uintptr_t)dst & 2))
+    {
+        *dst++ = color;
+        w--;
+    }
+    pixel_pair_t pair = ((uint32_t)color << 16) | color;
+    pixel_pair_t *d = (pixel_pair_t *)dst;
+    for (; w >= 2; w -= 2) *d++ = pair;
+    if (w) *(uint16_t *)d = color;
+}
+
+void span_fill(int x, int y, int w, uint16_t color)
+{
+    if (y < 0 || y >= DHEIGHT) return;
+    w = clip_span(&x, w);
+    if (w <= 0) return;
+    fill_row(gint_vram + y * DWIDTH + x, w, color);
+}
+
+void span_copy(int x, int y, const uint16_t *src, int w)
+{
+    if (y < 0 || y >= DHEIGHT) return;
+    int x0 = x;
+    w = clip_span(&x, w);
+    if (w <= 0) return;
+    memcpy(gint_vram + y * DWIDTH + x, src + (x - x0), (size_t)w * sizeof(uint16_t));
+}
+
+void span_rect(int x, int y, int w, int h, uint16_t color)
+{
+    if (y < 0)
+    {
+        h += y;
+        y = 0;
+    }
+    if (y + h > DHEIGHT) h = DHEIGHT - y;
+    w = clip_span(&x, w);
+    if (w <= 0 || h <= 0) return;
+
+    uint16_t *row = gint_vram + y * DWIDTH + x;
+    for (int i = 0; i < h; i++, row += DWIDTH) fill_row(row, w, color);
+}
+
+void span_blit(int x, int y, int w, int h, const uint16_t *src, int stride)
+{
+    // Clip rows, then let span_copy clip columns
+    if (y < 0)
+    {
+        src -= y * stride;
+        h += y;
+        y = 0;
+    }
+    if (y + h > DHEIGHT) h = DHEIGHT - y;
+    for (int i = 0; i < h; i++) span_copy(x, y + i, src + i * stride, w);
+}
@@ -0,0 +1,18 @@
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <stdint.h>
+
+// Row-oriented drawing straight into VRAM (gint_vram, DWIDTH pixels per
+// row). Everything is clipped to the screen; fills use word-sized stores
+
+// Fill w pixels of row y starting at x
+void span_fill(int x, int y, int w, uint16_t color);
+// Copy w pixels from src into row y starting at x
+void span_copy(int x, int y, const uint16_t *src, int w);
+// Fill a w x h rectangle with its top-left corner at (x, y)
+void span_rect(int x, int y, int w, int h, uint16_t color);
+// Copy a w x h image (rows `stride` pixels apart) with its top-left corner at (x, y)
+void span_blit(int x, int y, int w, int h, const uint16_t *src, int stride);
+
+#endif // SPAN_H
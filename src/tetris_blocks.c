@@ -1,13 +1,10 @@
-#include <gint/display.h>
-#include <gint/rtc.h>
-#include <gint/clock.h>
-#include <time.h>
 #include "tetris_blocks.h"
 #include "grid.h"
-#include "renderer.h"
+#include "piece_catalog.h"
 
 // pieces are in 4x4 matrices where 1 = block, 0 = empty
 // 7 base pieces × 4 rotations each = 28 total pieces
+// piece_catalog.c trims these boxes and collapses identical shapes
 static const int tetris_pieces[TETRIS_PIECES][4][4] = {
     // I-piece (line) - 4 rotations
     {
@@ -351,17 +348,6 @@ int tetris_piece_cell(int piece_type, int row, int col)
 }
 
 
-static int random_seed = 0;
-
-// Selection state
-static int selected_block = 0;  // First block is selected by default
-
-// Store the generated pieces
-static int stored_pieces[3] = {-1, -1, -1};  // -1 means not generated yet
-static uint16_t stored_piece_colors[3] = {0, 0, 0};
-
-static int get_random(void);
-
 static const uint16_t PIECE_PALETTE[7] = {
     0xF800, // red
     0xFD20, // orange
@@ -372,246 +358,190 @@ static const uint16_t PIECE_PALETTE[7] = {
     0xBA3F, // purple
 };
 
-static uint16_t random_palette_color(void)
-{
-    int idx = get_random() % 7;
-    return PIECE_PALETTE[idx];
-}
-
-static int get_random(void)
+static uint16_t random_palette_color(game_ctx_t *ctx)
 {
-    // Use clock for randomness
-    uint32_t time = clock();
-    random_seed = (random_seed * 1103515245 + 12345) ^ time;
-    return (random_seed >> 16) & 0x7FFF;
+    return PIECE_PALETTE[rng_below(&ctx->rng[RNG_STREAM_COLORS], 7)];
 }
 
 // Check if a small block would perfectly fit to break a line
-static int small_block_would_break_line(int piece_type)
+static int small_block_would_break_line(const game_ctx_t *ctx, int piece_type)
 {
     // Only check small blocks (39-43)
     if (piece_type < 39 || piece_type > 43) return 0;
     
-    // Check all possible positions on the grid
-    for (int y = 0; y < GRID_SIZE; y++)
-    {
-        for (int x = 0; x < GRID_SIZE; x++)
+    // Check every free anchor on the grid
+    const piece_info_t *info = piece_catalog_get(piece_type);
+    uint64_t anchors = piece_catalog_free_anchors(piece_type, ctx->grid.occupied);
+    for (int bit = 0; anchors; bit++, anchors >>= 1)
+    {
+        if (!(anchors & 1)) continue;
+        int x = bit % GRID_SIZE - info->box_col;
+        int y = bit / GRID_SIZE - info->box_row;
+        // Check if placing the piece here would clear lines
+        if (grid_would_clear_lines_ctx(ctx, piece_type, x, y))
         {
-            // Check if this piece can be placed here and would clear lines
-            if (grid_can_place(piece_type, x, y) && grid_would_clear_lines(piece_type, x, y))
-            {
-                return 1; // This small block would break a line
-            }
+            return 1; // This small block would break a line
         }
     }
     
     return 0; // No line breaking opportunity found
 }
 
-void tetris_blocks_init(void)
+void tetris_blocks_init_ctx(game_ctx_t *ctx, uint32_t seed)
 {
-    // Initialize random seed
-    uint32_t time = clock();
-    random_seed = time;
+    // Every random stream of the game starts from the seed
+    rng_t root;
+    rng_seed(&root, seed);
+    tetris_blocks_init_from_ctx(ctx, &root);
+}
+
+void tetris_blocks_init_from_ctx(game_ctx_t *ctx, const rng_t *root)
+{
+    tetris_blocks_state_t *b = &ctx->blocks;
+    piece_catalog_init();
+    rng_seed_streams_from(ctx->rng, root);
     
     // Reset selection to first block
-    selected_block = 0;
+    b->selected_block = 0;
     
     // Generate the three pieces with weighted spawning and placeability validation (js kill me)
-    tetris_generate_valid_pieces();
+    tetris_generate_valid_pieces_ctx(ctx);
 }
 
-int tetris_blocks_get_selection(void)
+int tetris_blocks_get_selection_ctx(const game_ctx_t *ctx)
 {
-    return selected_block;
-}
-
-void tetris_blocks_set_selection(int selection)
-{
-    if (selection >= 0 && selection < 3)  // we have 3 blocks
-    {
-        // Prefer requested selection if available, otherwise skip to next available
-        int start = selection;
-        for (int i = 0; i < 3; i++)
-        {
-            int idx = (start + i) % 3;
-            if (stored_pieces[idx] >= 0)
-            {
-                selected_block = idx;
-                return;
-            }
-        }
-        // No available pieces; keep selection as requested
-        selected_block = selection;
-    }
-}
-
-static void draw_tetris_piece_core(int x, int y, int piece_type, int is_selected, int block_size, int gap)
-{
-    if (piece_type < 0 || piece_type >= TETRIS_PIECES) return;
-
-    for (int row = 0; row < 4; row++)
-    {
-        for (int col = 0; col < 4; col++)
-        {
-            if (tetris_pieces[piece_type][row][col])
-            {
-                int block_x = x + col * (block_size + gap);
-                int block_y = y + row * (block_size + gap);
-
-                renderer_draw_beveled_tile(block_x, block_y, block_size, is_selected);
-            }
-        }
-    }
+    return ctx->blocks.selected_block;
 }
 
-void draw_tetris_piece(int x, int y, int piece_type, int is_selected)
+void tetris_blocks_set_selection_ctx(game_ctx_t *ctx, int selection)
 {
-    // sidebar preview: slightly smaller than grid cells with 1px gap
-    draw_tetris_piece_core(x, y, piece_type, is_selected, TETRIS_BLOCK_SIZE, 1);
+    int resolved = tetris_blocks_resolve_selection_ctx(ctx, selection);
+    if (resolved >= 0) ctx->blocks.selected_block = resolved;
 }
 
-void draw_tetris_piece_sized(int x, int y, int piece_type, int is_selected, int block_size, int gap)
+int tetris_blocks_resolve_selection_ctx(const game_ctx_t *ctx, int selection)
 {
-    // general-purpose draw
-    draw_tetris_piece_core(x, y, piece_type, is_selected, block_size, gap);
-}
+    const tetris_blocks_state_t *b = &ctx->blocks;
+    if (selection < 0 || selection >= 3) return -1;  // we have 3 blocks
 
-void tetris_blocks_draw(void)
-{
-    // Draw the stored pieces
-    // Ensure selection points to an available piece if any
-    if (selected_block < 0 || selected_block >= 3 || stored_pieces[selected_block] < 0)
-    {
-        for (int i = 0; i < 3; i++)
-        {
-            if (stored_pieces[i] >= 0)
-            {
-                selected_block = i;
-                break;
-            }
-        }
-    }
+    // Prefer requested selection if available, otherwise skip to next available
     for (int i = 0; i < 3; i++)
     {
-        int piece_type = stored_pieces[i];
-        int y_pos = TETRIS_AREA_Y + i * TETRIS_SPACING;
-        int is_selected = (i == selected_block);
-        if (piece_type < 0)
-        {
-            // Skip drawing consumed slots
-            continue;
-        }
-        
-        // Ensure sidebar uses the assigned piece color for this slot
-        uint16_t color = tetris_blocks_get_piece_color_for_slot(i);
-        renderer_set_tile_color(color);
-        draw_tetris_piece(TETRIS_AREA_X, y_pos, piece_type, is_selected);
+        int idx = (selection + i) % 3;
+        if (b->stored_pieces[idx] >= 0) return idx;
     }
+    // No available pieces; keep selection as requested
+    return selection;
 }
 
-int tetris_blocks_get_piece_type_for_selection(int selection)
+int tetris_blocks_get_piece_type_for_selection_ctx(const game_ctx_t *ctx, int selection)
 {
+    const tetris_blocks_state_t *b = &ctx->blocks;
     if (selection < 0 || selection >= 3) return -1;
     // If not generated or consumed, return -1
-    if (stored_pieces[selection] < 0 || stored_pieces[selection] >= TETRIS_PIECES)
+    if (b->stored_pieces[selection] < 0 || b->stored_pieces[selection] >= TETRIS_PIECES)
         return -1;
-    return stored_pieces[selection];
+    return b->stored_pieces[selection];
 }
 
 
-void tetris_blocks_consume_selected(void)
+void tetris_blocks_consume_selected_ctx(game_ctx_t *ctx)
 {
-    if (selected_block < 0 || selected_block >= 3) return;
-    stored_pieces[selected_block] = -1; // mark consumed
-    stored_piece_colors[selected_block] = 0;
+    tetris_blocks_state_t *b = &ctx->blocks;
+    if (b->selected_block < 0 || b->selected_block >= 3) return;
+    b->stored_pieces[b->selected_block] = -1; // mark consumed
+    b->stored_piece_colors[b->selected_block] = 0;
 
     // Move selection to next available piece if any
     for (int i = 0; i < 3; i++)
     {
-        int idx = (selected_block + i) % 3;
-        if (stored_pieces[idx] >= 0)
+        int idx = (b->selected_block + i) % 3;
+        if (b->stored_pieces[idx] >= 0)
         {
-            selected_block = idx;
+            b->selected_block = idx;
             return;
         }
     }
     // None left; don't regenerate immediately - wait for piece to be placed
 }
 
-void tetris_blocks_regenerate_if_needed(void)
+void tetris_blocks_regenerate_if_needed_ctx(game_ctx_t *ctx)
 {
+    tetris_blocks_state_t *b = &ctx->blocks;
     // Check if all pieces are consumed and regenerate if needed
     int remaining = 0;
     for (int i = 0; i < 3; i++)
     {
-        if (stored_pieces[i] >= 0) remaining++;
+        if (b->stored_pieces[i] >= 0) remaining++;
     }
     if (remaining == 0)
     {
         // Generate three new pieces with weighted spawning and placeability validation
-        tetris_generate_valid_pieces();
+        tetris_generate_valid_pieces_ctx(ctx);
     }
 }
 
-void tetris_blocks_get_available_pieces(int pieces[], int *count)
+void tetris_blocks_get_available_pieces_ctx(const game_ctx_t *ctx, int pieces[], int *count)
 {
+    const tetris_blocks_state_t *b = &ctx->blocks;
     int available_count = 0;
     for (int i = 0; i < 3; i++)
     {
-        if (stored_pieces[i] >= 0)
+        if (b->stored_pieces[i] >= 0)
         {
-            pieces[available_count] = stored_pieces[i];
+            pieces[available_count] = b->stored_pieces[i];
             available_count++;
         }
     }
     *count = available_count;
 }
 
-void tetris_blocks_restore_piece(int piece_type)
+void tetris_blocks_restore_piece_ctx(game_ctx_t *ctx, int piece_type)
 {
+    tetris_blocks_state_t *b = &ctx->blocks;
     if (piece_type < 0 || piece_type >= TETRIS_PIECES) return;
     
     // Find the first empty slot to restore the piece
     for (int i = 0; i < 3; i++)
     {
-        if (stored_pieces[i] < 0) // Empty slot found
+        if (b->stored_pieces[i] < 0) // Empty slot found
         {
-            stored_pieces[i] = piece_type;
-            stored_piece_colors[i] = random_palette_color();
+            b->stored_pieces[i] = piece_type;
+            b->stored_piece_colors[i] = random_palette_color(ctx);
             // Set this as the selected piece
-            selected_block = i;
+            b->selected_block = i;
             return;
         }
     }
     
     // If no empty slot found, replace the current selection
-    if (selected_block >= 0 && selected_block < 3)
+    if (b->selected_block >= 0 && b->selected_block < 3)
     {
-        stored_pieces[selected_block] = piece_type;
-        stored_piece_colors[selected_block] = random_palette_color();
+        b->stored_pieces[b->selected_block] = piece_type;
+        b->stored_piece_colors[b->selected_block] = random_palette_color(ctx);
     }
 }
 
-void tetris_blocks_restore_piece_with_color(int piece_type, uint16_t color)
+void tetris_blocks_restore_piece_with_color_ctx(game_ctx_t *ctx, int piece_type, uint16_t color)
 {
+    tetris_blocks_state_t *b = &ctx->blocks;
     if (piece_type < 0 || piece_type >= TETRIS_PIECES) return;
     // find first empty slot
     for (int i = 0; i < 3; i++)
     {
-        if (stored_pieces[i] < 0)
+        if (b->stored_pieces[i] < 0)
         {
-            stored_pieces[i] = piece_type;
-            stored_piece_colors[i] = color;
-            selected_block = i;
+            b->stored_pieces[i] = piece_type;
+            b->stored_piece_colors[i] = color;
+            b->selected_block = i;
             return;
         }
     }
     // (fallback): overwrite selection
-    if (selected_block >= 0 && selected_block < 3)
+    if (b->selected_block >= 0 && b->selected_block < 3)
     {
-        stored_pieces[selected_block] = piece_type;
-        stored_piece_colors[selected_block] = color;
+        b->stored_pieces[b->selected_block] = piece_type;
+        b->stored_piece_colors[b->selected_block] = color;
     }
 }
 
@@ -621,25 +551,13 @@ piece_difficulty_t tetris_get_piece_difficulty(int piece_type)
     return piece_difficulties[piece_type];
 }
 
-int tetris_piece_is_placeable(int piece_type)
+int tetris_piece_is_placeable_ctx(const game_ctx_t *ctx, int piece_type)
 {
-    if (piece_type < 0 || piece_type >= TETRIS_PIECES) return 0;
-    
-    // Check if piece can be placed anywhere on the current grid
-    for (int gy = 0; gy < GRID_SIZE; gy++)
-    {
-        for (int gx = 0; gx < GRID_SIZE; gx++)
-        {
-            if (grid_can_place(piece_type, gx, gy))
-            {
-                return 1; // Piece can be placed at least somewhere
-            }
-        }
-    }
-    return 0; // Piece cannot be placed anywhere
+    // Check the piece's legal anchors against the current grid
+    return piece_catalog_free_anchors(piece_type, ctx->grid.occupied) != 0;
 }
 
-int tetris_generate_weighted_piece(void)
+int tetris_generate_weighted_piece_ctx(game_ctx_t *ctx)
 {
     // Calculate total weight for all pieces
     int total_weight = 0;
@@ -656,7 +574,7 @@ int tetris_generate_weighted_piece(void)
     }
     
     // Generate random number in range [0, total_weight)
-    int random_value = get_random() % total_weight;
+    int random_value = (int)rng_below(&ctx->rng[RNG_STREAM_PIECES], (uint32_t)total_weight);
     
     // Find which piece this random value corresponds to
     int current_weight = 0;
@@ -683,9 +601,10 @@ int tetris_generate_weighted_piece(void)
     return 0;
 }
 
-void tetris_generate_valid_pieces(void)
+void tetris_generate_valid_pieces_ctx(game_ctx_t *ctx)
 {
-    int spawned_types[TETRIS_PIECES] = {0}; // Track which types we've spawned
+    tetris_blocks_state_t *b = &ctx->blocks;
+    int spawned_types[TETRIS_PIECES] = {0}; // Track which shapes we've spawned, by canonical id
     int attempts = 0;
     const int max_attempts = 100; // Prevent infinite loops
     const int small_block_chance = 8; // 8% chance for small blocks (1-100)
@@ -693,8 +612,8 @@ void tetris_generate_valid_pieces(void)
     // Clear current pieces
     for (int i = 0; i < 3; i++)
     {
-        stored_pieces[i] = -1;
-        stored_piece_colors[i] = 0;
+        b->stored_pieces[i] = -1;
+        b->stored_piece_colors[i] = 0;
     }
     
     // Generate 3 valid pieces
@@ -704,7 +623,7 @@ void tetris_generate_valid_pieces(void)
         attempts = 0;
         
         // Check if we should try to spawn a small block for line breaking
-        int try_small_block = (get_random() % 100) < small_block_chance;
+        int try_small_block = (int)rng_below(&ctx->rng[RNG_STREAM_PIECES], 100) < small_block_chance;
         
         // Keep trying until we find a valid piece
         while (attempts < max_attempts)
@@ -717,12 +636,12 @@ void tetris_generate_valid_pieces(void)
                 // Try small blocks (39-43) that would break lines
                 for (int small_piece = 39; small_piece <= 43; small_piece++)
                 {
-                    if (!spawned_types[small_piece] && 
-                        tetris_piece_is_placeable(small_piece) &&
-                        small_block_would_break_line(small_piece))
+                    if (!spawned_types[piece_catalog_get(small_piece)->canonical] && 
+                        tetris_piece_is_placeable_ctx(ctx, small_piece) &&
+                        small_block_would_break_line(ctx, small_piece))
                     {
                         piece_type = small_piece;
-                        spawned_types[small_piece] = 1;
+                        spawned_types[piece_catalog_get(small_piece)->canonical] = 1;
                         break;
                     }
                 }
@@ -730,20 +649,20 @@ void tetris_generate_valid_pieces(void)
             }
             
             // Generate a weighted random piece
-            candidate = tetris_generate_weighted_piece();
+            candidate = tetris_generate_weighted_piece_ctx(ctx);
             
-            // Check if we already spawned this type
-            if (spawned_types[candidate])
+            // Check if we already spawned this shape
+            if (spawned_types[piece_catalog_get(candidate)->canonical])
             {
                 attempts++;
                 continue;
             }
             
             // Check if this piece is placeable
-            if (tetris_piece_is_placeable(candidate))
+            if (tetris_piece_is_placeable_ctx(ctx, candidate))
             {
                 piece_type = candidate;
-                spawned_types[candidate] = 1; // Mark as spawned
+                spawned_types[piece_catalog_get(candidate)->canonical] = 1; // Mark as spawned
                 break;
             }
             
@@ -755,10 +674,11 @@ void tetris_generate_valid_pieces(void)
         {
             for (int i = 0; i < TETRIS_PIECES; i++)
             {
-                if (!spawned_types[i] && tetris_piece_is_placeable(i))
+                int canonical = piece_catalog_get(i)->canonical;
+                if (!spawned_types[canonical] && tetris_piece_is_placeable_ctx(ctx, i))
                 {
                     piece_type = i;
-                    spawned_types[i] = 1;
+                    spawned_types[canonical] = 1;
                     break;
                 }
             }
@@ -769,39 +689,42 @@ void tetris_generate_valid_pieces(void)
         {
             for (int i = 0; i < TETRIS_PIECES; i++)
             {
-                if (!spawned_types[i])
+                int canonical = piece_catalog_get(i)->canonical;
+                if (!spawned_types[canonical])
                 {
                     piece_type = i;
-                    spawned_types[i] = 1;
+                    spawned_types[canonical] = 1;
                     break;
                 }
             }
         }
         
-        stored_pieces[slot] = piece_type;
-        stored_piece_colors[slot] = random_palette_color();
+        b->stored_pieces[slot] = piece_type;
+        b->stored_piece_colors[slot] = random_palette_color(ctx);
     }
     
     // Reset selection to first piece
-    selected_block = 0;
+    b->selected_block = 0;
 }
 
-uint16_t tetris_blocks_get_piece_color_for_slot(int slot)
+uint16_t tetris_blocks_get_piece_color_for_slot_ctx(const game_ctx_t *ctx, int slot)
 {
+    const tetris_blocks_state_t *b = &ctx->blocks;
     if (slot < 0 || slot >= 3) return COLOR_TETRIS_RED;
-    if (stored_pieces[slot] < 0) return COLOR_TETRIS_RED;
-    uint16_t c = stored_piece_colors[slot];
+    if (b->stored_pieces[slot] < 0) return COLOR_TETRIS_RED;
+    uint16_t c = b->stored_piece_colors[slot];
     return c ? c : COLOR_TETRIS_RED;
 }
 
-uint16_t tetris_blocks_get_color_for_piece_type(int piece_type)
+uint16_t tetris_blocks_get_color_for_piece_type_ctx(const game_ctx_t *ctx, int piece_type)
 {
+    const tetris_blocks_state_t *b = &ctx->blocks;
     // Find the piece in the sidebar and return its assigned color
     for (int i = 0; i < 3; i++)
     {
-        if (stored_pieces[i] == piece_type)
+        if (b->stored_pieces[i] == piece_type)
         {
-            uint16_t c = stored_piece_colors[i];
+            uint16_t c = b->stored_piece_colors[i];
             return c ? c : COLOR_TETRIS_RED;
         }
     }
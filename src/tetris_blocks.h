@@ -1,7 +1,8 @@
 #ifndef TETRIS_BLOCKS_H
 #define TETRIS_BLOCKS_H
 
-#include <gint/display.h>
+#include <stdint.h>
+#include "game_ctx.h"
 
 // Tetris block colors (RGB565 format for CG-50)
 #define COLOR_TETRIS_RED 0xF800  // Red in RGB565
@@ -32,34 +33,60 @@ typedef enum {
 #define HARD_WEIGHT 3
 #define RARE_WEIGHT 1
 
-// Function declarations
-void tetris_blocks_init(void);
-void tetris_blocks_draw(void);
-void draw_tetris_piece(int x, int y, int piece_type, int is_selected);
-void draw_tetris_piece_sized(int x, int y, int piece_type, int is_selected, int block_size, int gap);
+// Sidebar on an explicit context (tetris_blocks.c)
+// Reset the sidebar and deal three pieces; the seed fixes the piece/color sequence
+void tetris_blocks_init_ctx(game_ctx_t *ctx, uint32_t seed);
+// The same with the streams started from root (rng_seed_streams_from)
+void tetris_blocks_init_from_ctx(game_ctx_t *ctx, const rng_t *root);
+int tetris_blocks_get_selection_ctx(const game_ctx_t *ctx);
+void tetris_blocks_set_selection_ctx(game_ctx_t *ctx, int selection);
+// Slot tetris_blocks_set_selection_ctx would select: selection, or the next
+// slot holding a piece after it; -1 if selection is out of range
+int tetris_blocks_resolve_selection_ctx(const game_ctx_t *ctx, int selection);
+int tetris_blocks_get_piece_type_for_selection_ctx(const game_ctx_t *ctx, int selection);
+// Get the RGB565 color for a sidebar piece slot. Returns default red
+uint16_t tetris_blocks_get_piece_color_for_slot_ctx(const game_ctx_t *ctx, int slot);
+// Get the RGB565 color for a given piece type in the sidebar, or default
+uint16_t tetris_blocks_get_color_for_piece_type_ctx(const game_ctx_t *ctx, int piece_type);
+void tetris_blocks_consume_selected_ctx(game_ctx_t *ctx);
+void tetris_blocks_regenerate_if_needed_ctx(game_ctx_t *ctx);
+// Get all available (non-consumed) pieces
+void tetris_blocks_get_available_pieces_ctx(const game_ctx_t *ctx, int pieces[], int *count);
+// Restore a piece back to the sidebar (undo consumption)
+void tetris_blocks_restore_piece_ctx(game_ctx_t *ctx, int piece_type);
+// Restore a piece back with a specific color
+void tetris_blocks_restore_piece_with_color_ctx(game_ctx_t *ctx, int piece_type, uint16_t color);
+// Check if a piece can be placed anywhere on the current grid
+int tetris_piece_is_placeable_ctx(const game_ctx_t *ctx, int piece_type);
+// Generate weighted random piece based on difficulty
+int tetris_generate_weighted_piece_ctx(game_ctx_t *ctx);
+// Generate 3 new pieces with placeability validation and no duplicates
+void tetris_generate_valid_pieces_ctx(game_ctx_t *ctx);
+
+// Piece table lookups; need no context
+int tetris_piece_cell(int piece_type, int row, int col);
+// Get piece difficulty category
+piece_difficulty_t tetris_get_piece_difficulty(int piece_type);
+
+// The same on game_ctx_default() (game_compat.c)
+void tetris_blocks_init(uint32_t seed);
 int tetris_blocks_get_selection(void);
 void tetris_blocks_set_selection(int selection);
 int tetris_blocks_get_piece_type_for_selection(int selection);
-// Get the RGB565 color for a sidebar piece slot. Returns default red
 uint16_t tetris_blocks_get_piece_color_for_slot(int slot);
-// Get the RGB565 color for a given piece type in the sidebar, or default
 uint16_t tetris_blocks_get_color_for_piece_type(int piece_type);
-int tetris_piece_cell(int piece_type, int row, int col);
 void tetris_blocks_consume_selected(void);
 void tetris_blocks_regenerate_if_needed(void);
-// Get all available (non-consumed) pieces
 void tetris_blocks_get_available_pieces(int pieces[], int *count);
-// Restore a piece back to the sidebar (undo consumption)
 void tetris_blocks_restore_piece(int piece_type);
-// Restore a piece back with a specific color
 void tetris_blocks_restore_piece_with_color(int piece_type, uint16_t color);
-// Get piece difficulty category
-piece_difficulty_t tetris_get_piece_difficulty(int piece_type);
-// Check if a piece can be placed anywhere on the current grid
 int tetris_piece_is_placeable(int piece_type);
-// Generate weighted random piece based on difficulty
 int tetris_generate_weighted_piece(void);
-// Generate 3 new pieces with placeability validation and no duplicates
 void tetris_generate_valid_pieces(void);
 
+// Drawing (tetris_blocks_draw.c, add-in only)
+void tetris_blocks_draw(void);
+void draw_tetris_piece(int x, int y, int piece_type, int is_selected);
+void draw_tetris_piece_sized(int x, int y, int piece_type, int is_selected, int block_size, int gap);
+
 #endif // TETRIS_BLOCKS_H
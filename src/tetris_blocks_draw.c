@@ -0,0 +1,67 @@
+#include <gint/display.h>
+#include "tetris_blocks.h"
+#include "renderer.h"
+#include "piece_catalog.h"
+
+static void draw_tetris_piece_core(int x, int y, int piece_type, int is_selected, int block_size, int gap)
+{
+    const piece_info_t *info = piece_catalog_get(piece_type);
+    if (!info) return;
+
+    const piece_shape_t *shape = info->shape;
+    for (int i = 0; i < shape->num_cells; i++)
+    {
+        int col = info->box_col + shape->cells[i].dx;
+        int row = info->box_row + shape->cells[i].dy;
+        int block_x = x + col * (block_size + gap);
+        int block_y = y + row * (block_size + gap);
+
+        renderer_draw_beveled_tile(block_x, block_y, block_size, is_selected);
+    }
+}
+
+void draw_tetris_piece(int x, int y, int piece_type, int is_selected)
+{
+    // sidebar preview: slightly smaller than grid cells with 1px gap
+    draw_tetris_piece_core(x, y, piece_type, is_selected, TETRIS_BLOCK_SIZE, 1);
+}
+
+void draw_tetris_piece_sized(int x, int y, int piece_type, int is_selected, int block_size, int gap)
+{
+    // general-purpose draw
+    draw_tetris_piece_core(x, y, piece_type, is_selected, block_size, gap);
+}
+
+void tetris_blocks_draw(void)
+{
+    // Draw the stored pieces
+    // Highlight the first available piece if the selection points to a consumed slot
+    int selected_block = tetris_blocks_get_selection();
+    if (tetris_blocks_get_piece_type_for_selection(selected_block) < 0)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            if (tetris_blocks_get_piece_type_for_selection(i) >= 0)
+            {
+                selected_block = i;
+                break;
+            }
+        }
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        int piece_type = tetris_blocks_get_piece_type_for_selection(i);
+        int y_pos = TETRIS_AREA_Y + i * TETRIS_SPACING;
+        int is_selected = (i == selected_block);
+        if (piece_type < 0)
+        {
+            // Skip drawing consumed slots
+            continue;
+        }
+        
+        // Ensure sidebar uses the assigned piece color for this slot
+        uint16_t color = tetris_blocks_get_piece_color_for_slot(i);
+        renderer_set_tile_color(color);
+        draw_tetris_piece(TETRIS_AREA_X, y_pos, piece_type, is_selected);
+    }
+}
@@ -0,0 +1,27 @@
+#include <stddef.h>
+#include "tile_atlas.h"
+#include "tile_atlas_layout.h"
+
+const uint16_t *tile_atlas_find(int size, int is_selected, uint16_t base, int *stride)
+{
+#ifdef TILE_ATLAS_NONE
+    // No atlas image on this platform: every tile goes through the slots
+    (void)size; (void)is_selected; (void)base; (void)stride;
+    return NULL;
+#else
+    uint32_t key = ((uint32_t)size << 17) | ((uint32_t)(is_selected != 0) << 16) | base;
+
+    // Binary search over the sorted keys
+    int lo = 0, hi = TILE_ATLAS_ENTRIES;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (tile_atlas_keys[mid] < key) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == TILE_ATLAS_ENTRIES || tile_atlas_keys[lo] != key) return NULL;
+
+    const uint16_t *pixels = tile_atlas_pixels(stride);
+    return pixels + tile_atlas_xy[lo][1] * *stride + tile_atlas_xy[lo][0];
+#endif
+}
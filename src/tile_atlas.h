@@ -0,0 +1,19 @@
+#ifndef TILE_ATLAS_H
+#define TILE_ATLAS_H
+
+#include <stdint.h>
+
+// Beveled tiles pre-rendered at build time (tools/gen_tile_atlas.py): every
+// piece palette color, plain and with the active block's two tints, at grid
+// and sidebar size, selected or not
+
+// Top-left pixel of the tile in the atlas, or NULL if the atlas does not
+// have it (always without one, in TILE_ATLAS_NONE builds); rows are
+// *stride pixels apart
+const uint16_t *tile_atlas_find(int size, int is_selected, uint16_t base, int *stride);
+
+// The atlas image: the fxconv asset on the add-in (tile_atlas_image.c), a
+// generated array on the host
+const uint16_t *tile_atlas_pixels(int *stride);
+
+#endif // TILE_ATLAS_H
@@ -0,0 +1,11 @@
+#include <gint/image.h>
+#include "tile_atlas.h"
+
+// Converted by fxconv from the generated tile_atlas.png
+extern image_t img_tile_atlas;
+
+const uint16_t *tile_atlas_pixels(int *stride)
+{
+    *stride = img_tile_atlas.stride / 2;
+    return img_tile_atlas.data;
+}
@@ -0,0 +1,135 @@
+#include <gint/display.h>
+#include <string.h>
+#include "tile_cache.h"
+#include "blend.h"
+#include "span.h"
+#include "tile_atlas.h"
+
+#define COLOR_BLACK 0x0000       // Black in RGB565
+#define COLOR_WHITE 0xFFFF       // White in RGB565
+
+typedef struct {
+    uint32_t key;       // 0 means the slot is free
+    uint32_t last_used;
+} tile_slot_t;
+
+static tile_slot_t slots[TILE_CACHE_SLOTS];
+static uint16_t slot_pixels[TILE_CACHE_SLOTS][TILE_CACHE_MAX_SIZE * TILE_CACHE_MAX_SIZE];
+static uint32_t use_clock = 0;
+static tile_cache_stats_t stats;
+
+// color, size and selection packed into a nonzero key
+static uint32_t tile_key(int size, int is_selected, uint16_t base)
+{
+    return ((uint32_t)size << 17) | ((uint32_t)(is_selected != 0) << 16) | base;
+}
+
+// Rasterize a beveled tile into dst (rows `stride` pixels apart)
+static void raster_bevel_tile(uint16_t *dst, int stride, int size, int is_selected, uint16_t base)
+{
+    // Base color with darker shading
+    const uint16_t deep = blend565(base, COLOR_BLACK, 180); // darker red
+
+    int maxd2 = (size*size)/2;
+    if (maxd2 <= 0) maxd2 = 1;
+    for (int py = 0; py < size; py++)
+    {
+        for (int px = 0; px < size; px++)
+        {
+            // radialish gradient weight (one divide per pixel, cache misses only)
+            int dx = (px - size / 2);
+            int dy = (py - size / 2);
+            int d2 = dx*dx + dy*dy;
+            int t = d2 * 255 / maxd2; if (t > 255) t = 255;
+            dst[py * stride + px] = blend565(base, deep, t/2);
+        }
+    }
+
+    // Bevel: light top-left, dark bottom-right
+    int rim = size / 6; if (rim < 2) rim = 2; if (rim > 4) rim = 4;
+    for (int i = 0; i < rim; i++)
+    {
+        uint16_t edgeLight = blend565(base, COLOR_WHITE, 160 - i*40);
+        uint16_t edgeDark = blend565(base, deep, 200);
+        // top
+        for (int px = i; px < size - i; px++) dst[i * stride + px] = edgeLight;
+        // left
+        for (int py = i; py < size - i; py++) dst[py * stride + i] = edgeLight;
+        // bottom
+        for (int px = i; px < size - i; px++) dst[(size - 1 - i) * stride + px] = edgeDark;
+        // right
+        for (int py = i; py < size - i; py++) dst[py * stride + size - 1 - i] = edgeDark;
+    }
+
+    // Thin outer border for definition, white when selected
+    uint16_t border = is_selected ? COLOR_WHITE : COLOR_BLACK;
+    for (int px = 0; px < size; px++) { dst[px] = border; dst[(size - 1) * stride + px] = border; }
+    for (int py = 0; py < size; py++) { dst[py * stride] = border; dst[py * stride + size - 1] = border; }
+}
+
+// Sprite for the key, rasterizing it into the least recently used slot on a miss
+static const uint16_t *lookup(int size, int is_selected, uint16_t base)
+{
+    uint32_t key = tile_key(size, is_selected, base);
+    int victim = 0;
+    use_clock++;
+
+    for (int i = 0; i < TILE_CACHE_SLOTS; i++)
+    {
+        if (slots[i].key == key)
+        {
+            slots[i].last_used = use_clock;
+            stats.hits++;
+            return slot_pixels[i];
+        }
+        // free slots have last_used 0 and are taken first
+        if (slots[i].last_used < slots[victim].last_used) victim = i;
+    }
+
+    stats.misses++;
+    if (slots[victim].key) stats.evictions++;
+    else stats.entries++;
+    slots[victim].key = key;
+    slots[victim].last_used = use_clock;
+    raster_bevel_tile(slot_pixels[victim], size, size, is_selected, base);
+    return slot_pixels[victim];
+}
+
+void tile_cache_draw(int x, int y, int size, int is_selected, uint16_t base)
+{
+    if (size <= 0) return;
+
+    // Every tile the game draws is in the build-time atlas; the slots only
+    // serve other colors and sizes
+    int stride;
+    const uint16_t *prebuilt = tile_atlas_find(size, is_selected, base, &stride);
+    if (prebuilt)
+    {
+        stats.atlas++;
+        span_blit(x, y, size, size, prebuilt, stride);
+        return;
+    }
+
+    if (size > TILE_CACHE_MAX_SIZE || TILE_CACHE_SLOTS == 0)
+    {
+        // Too big for a slot: rasterize straight into VRAM when fully visible
+        stats.uncached++;
+        if (x >= 0 && y >= 0 && x + size <= DWIDTH && y + size <= DHEIGHT)
+        {
+            raster_bevel_tile(gint_vram + y * DWIDTH + x, DWIDTH, size, is_selected, base);
+        }
+        return;
+    }
+    span_blit(x, y, size, size, lookup(size, is_selected, base), size);
+}
+
+void tile_cache_flush(void)
+{
+    memset(slots, 0, sizeof(slots));
+    stats.entries = 0;
+}
+
+void tile_cache_get_stats(tile_cache_stats_t *out)
+{
+    *out = stats;
+}
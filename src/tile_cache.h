@@ -0,0 +1,34 @@
+#ifndef TILE_CACHE_H
+#define TILE_CACHE_H
+
+#include <stdint.h>
+
+// Beveled tiles come from the build-time atlas (tile_atlas.h) when it has
+// them. Others are rasterized once per (color, size, selected) into a fixed
+// pool of sprite slots and blitted with row copies afterwards. Tinted tiles
+// (active block) are keyed by their tinted color
+
+// Largest tile size the sprite pool holds, and its memory cap. The atlas
+// has every tile the game draws, so a few slots cover the fallback path
+#define TILE_CACHE_MAX_SIZE 20
+#ifndef TILE_CACHE_BYTES
+#define TILE_CACHE_BYTES (4 * TILE_CACHE_MAX_SIZE * TILE_CACHE_MAX_SIZE * 2)
+#endif
+#define TILE_CACHE_SLOTS (TILE_CACHE_BYTES / (TILE_CACHE_MAX_SIZE * TILE_CACHE_MAX_SIZE * 2))
+
+typedef struct {
+    uint32_t atlas;      // blitted from the prebuilt atlas
+    uint32_t hits;
+    uint32_t misses;     // rasterized into a slot (includes evictions)
+    uint32_t evictions;  // least recently used slot reused
+    uint32_t uncached;   // larger than TILE_CACHE_MAX_SIZE, drawn directly
+    int entries;         // slots in use, at most TILE_CACHE_SLOTS
+} tile_cache_stats_t;
+
+// Draw a size x size beveled tile of the given base color at (x, y)
+void tile_cache_draw(int x, int y, int size, int is_selected, uint16_t base);
+// Drop every cached sprite (counters are kept)
+void tile_cache_flush(void);
+void tile_cache_get_stats(tile_cache_stats_t *stats);
+
+#endif // TILE_CACHE_H
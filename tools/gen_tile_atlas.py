@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+# Pre-renders every beveled tile the game draws into one RGB565 atlas:
+# each PIECE_PALETTE color (read from src/tetris_blocks.c), plain and with
+# the two active-block tints of grid_draw.c, at grid and sidebar size,
+# selected and unselected.
+#
+#   gen_tile_atlas.py --palette src/tetris_blocks.c --out-dir DIR [--png] [--c]
+#                     [--budget-kib N]
+#
+# Always writes DIR/tile_atlas_layout.h (where each tile is). --png writes
+# DIR/tile_atlas.png with its fxconv-metadata.txt for the add-in, --c writes
+# DIR/tile_atlas_pixels.c with the same pixels for the host build.
+#
+# The rasterizer below must stay identical to raster_bevel_tile() in
+# src/tile_cache.c; blockblast-render --check catches any difference.
+
+import argparse
+import os
+import re
+import struct
+import sys
+import zlib
+
+# GRID_CELL_SIZE (grid.h) and TETRIS_BLOCK_SIZE (tetris_blocks.h)
+SIZES = (20, 15)
+# set_active_tint() in grid_draw.c: (blend target, weight); None is untinted
+TINTS = (None, (0x7800, 200), (0xFFFF, 96))
+
+COLOR_BLACK = 0x0000
+COLOR_WHITE = 0xFFFF
+
+
+def blend565(a, b, t):
+    # blend565() of blend.h, exact /255 rounding included
+    def channel(ca, cb):
+        x = ca * (255 - t) + cb * t
+        return (x + 1 + (x >> 8)) >> 8
+    r = channel((a >> 11) & 0x1F, (b >> 11) & 0x1F)
+    g = channel((a >> 5) & 0x3F, (b >> 5) & 0x3F)
+    bl = channel(a & 0x1F, b & 0x1F)
+    return (r << 11) | (g << 5) | bl
+
+
+def raster_bevel_tile(size, is_selected, base):
+    dst = [[0] * size for _ in range(size)]
+    deep = blend565(base, COLOR_BLACK, 180)
+
+    maxd2 = max((size * size) // 2, 1)
+    for py in range(size):
+        for px in range(size):
+            dx = px - size // 2
+            dy = py - size // 2
+            t = min((dx * dx + dy * dy) * 255 // maxd2, 255)
+            dst[py][px] = blend565(base, deep, t // 2)
+
+    rim = min(max(size // 6, 2), 4)
+    for i in range(rim):
+        light = blend565(base, COLOR_WHITE, 160 - i * 40)
+        dark = blend565(base, deep, 200)
+        for p in range(i, size - i):
+            dst[i][p] = light
+            dst[p][i] = light
+        for p in range(i, size - i):
+            dst[size - 1 - i][p] = dark
+            dst[p][size - 1 - i] = dark
+
+    border = COLOR_WHITE if is_selected else COLOR_BLACK
+    for p in range(size):
+        dst[0][p] = dst[size - 1][p] = border
+        dst[p][0] = dst[p][size - 1] = border
+    return dst
+
+
+def read_palette(path):
+    with open(path) as fp:
+        source = fp.read()
+    m = re.search(r"PIECE_PALETTE\[\d*\]\s*=\s*\{(.*?)\};", source, re.S)
+    if not m:
+        sys.exit(f"{path}: PIECE_PALETTE not found")
+    body = re.sub(r"//[^\n]*", "", m.group(1))
+    return [int(v, 16) for v in re.findall(r"0x[0-9A-Fa-f]+", body)]
+
+
+def build_atlas(palette):
+    # One band per size; in a band, one row per (tint, selected) and one
+    # column per palette color
+    width = len(palette) * max(SIZES)
+    height = sum(size * len(TINTS) * 2 for size in SIZES)
+    pixels = [[0] * width for _ in range(height)]
+    entries = {}
+
+    y = 0
+    for size in SIZES:
+        for tint in TINTS:
+            for selected in (0, 1):
+                for col, color in enumerate(palette):
+                    base = color if tint is None else blend565(color, tint[0], tint[1])
+                    key = (size << 17) | (selected << 16) | base
+                    if key in entries:
+                        continue
+                    x = col * size
+                    tile = raster_bevel_tile(size, selected, base)
+                    for row in range(size):
+                        pixels[y + row][x:x + size] = tile[row]
+                    entries[key] = (x, y)
+                y += size
+    return width, height, pixels, entries
+
+
+def write_layout(path, width, height, entries):
+    keys = sorted(entries)
+    with open(path, "w") as fp:
+        fp.write("// Generated by tools/gen_tile_atlas.py, do not edit\n")
+        fp.write("#ifndef TILE_ATLAS_LAYOUT_H\n#define TILE_ATLAS_LAYOUT_H\n\n")
+        fp.write(f"#define TILE_ATLAS_WIDTH {width}\n")
+        fp.write(f"#define TILE_ATLAS_HEIGHT {height}\n")
+        fp.write(f"#define TILE_ATLAS_ENTRIES {len(keys)}\n\n")
+        fp.write("// (size << 17) | (selected << 16) | base color, sorted\n")
+        fp.write("static const uint32_t tile_atlas_keys[TILE_ATLAS_ENTRIES] = {\n")
+        for k in keys:
+            fp.write(f"    0x{k:06X},\n")
+        fp.write("};\n\n")
+        fp.write("// Top-left corner of each tile in the atlas\n")
+        fp.write("static const uint16_t tile_atlas_xy[TILE_ATLAS_ENTRIES][2] = {\n")
+        for k in keys:
+            x, y = entries[k]
+            fp.write(f"    {{ {x}, {y} }},\n")
+        fp.write("};\n\n#endif // TILE_ATLAS_LAYOUT_H\n")
+
+
+def write_png(path, width, height, pixels):
+    # RGB565 widened to 8 bits per channel by bit replication, which
+    # fxconv's rgb565 conversion maps back to the same values
+    raw = bytearray()
+    for row in pixels:
+        raw.append(0)
+        for c in row:
+            r, g, b = c >> 11, (c >> 5) & 0x3F, c & 0x1F
+            raw += bytes(((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)))
+
+    def chunk(kind, data):
+        return struct.pack(">I", len(data)) + kind + data + struct.pack(">I", zlib.crc32(kind + data))
+
+    with open(path, "wb") as fp:
+        fp.write(b"\x89PNG\r\n\x1a\n")
+        fp.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 2, 0, 0, 0)))
+        fp.write(chunk(b"IDAT", zlib.compress(bytes(raw), 9)))
+        fp.write(chunk(b"IEND", b""))
+
+    with open(os.path.join(os.path.dirname(path), "fxconv-metadata.txt"), "w") as fp:
+        fp.write("tile_atlas.png:\n  type: bopti-image\n  profile: rgb565\n  name: img_tile_atlas\n")
+
+
+def write_c(path, width, height, pixels):
+    with open(path, "w") as fp:
+        fp.write("// Generated by tools/gen_tile_atlas.py, do not edit\n")
+        fp.write("#include <stdint.h>\n#include \"tile_atlas.h\"\n\n")
+        fp.write(f"static const uint16_t atlas[{height} * {width}] = {{\n")
+        for row in pixels:
+            fp.write("    " + ", ".join(f"0x{c:04X}" for c in row) + ",\n")
+        fp.write("};\n\n")
+        fp.write("const uint16_t *tile_atlas_pixels(int *stride)\n{\n")
+        fp.write(f"    *stride = {width};\n    return atlas;\n}}\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--palette", required=True, help="source file defining PIECE_PALETTE")
+    parser.add_argument("--out-dir", required=True)
+    parser.add_argument("--png", action="store_true", help="write the fxconv image")
+    parser.add_argument("--c", action="store_true", help="write the pixels as C (host)")
+    parser.add_argument("--budget-kib", type=int, default=2048, help="g3a size budget to report against")
+    args = parser.parse_args()
+
+    palette = read_palette(args.palette)
+    width, height, pixels, entries = build_atlas(palette)
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    write_layout(os.path.join(args.out_dir, "tile_atlas_layout.h"), width, height, entries)
+    if args.png:
+        write_png(os.path.join(args.out_dir, "tile_atlas.png"), width, height, pixels)
+    if args.c:
+        write_c(os.path.join(args.out_dir, "tile_atlas_pixels.c"), width, height, pixels)
+
+    size = width * height * 2
+    budget = args.budget_kib * 1024
+    print(f"tile atlas: {len(entries)} tiles, {width}x{height} RGB565, {size} bytes "
+          f"({100.0 * size / budget:.1f}% of the {args.budget_kib} KiB g3a budget)")
+
+
+if __name__ == "__main__":
+    main()